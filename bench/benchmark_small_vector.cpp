@@ -2,38 +2,102 @@
 // SPDX-License-Identifier: Unlicense
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
 #include <random>
 
 #include "SmallVector.h"
-#include "small_vector\small_vector.h"
+#include "small_vector/small_vector.h"
+#include "small_vector/algorithm.h"
+#include "small_vector/small_flat_map.h"
+#include "small_vector/thread_cache.h"
 
 #include <benchmark/benchmark.h>
 
+//gcc doesn't know that the replaced operator new uses malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+//the global operator new counts the heap allocations, the benchmarks report them per iteration
+//(containers which call malloc directly, like llvm_vecsmall::SmallVector or sbo::malloc_allocator, are not counted).
+//The count is per thread, so the multi threaded benchmarks don't contend on it.
+static thread_local size_t g_heapAllocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_heapAllocations;
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return ::operator new(size, tag); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+static void report_allocations(benchmark::State& state, size_t allocationsBefore) {
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(g_heapAllocations - allocationsBefore), 
+                                                       benchmark::Counter::kAvgIterations);
+}
+
 template<typename ContainerT>
 static void ConstructWithSize(benchmark::State& state) {
     
+    const size_t allocations = g_heapAllocations;
     for (auto _ : state) {
         (void)_;
         ContainerT v(static_cast<size_t>(state.range(0)));
         benchmark::DoNotOptimize(v.data());
         benchmark::ClobberMemory();
     }
+    report_allocations(state, allocations);
+}
+
+//leaves the elements uninitialized, for buffers which are filled right afterwards
+template<typename ContainerT>
+static void ConstructWithSizeForOverwrite(benchmark::State& state) {
+
+    const size_t allocations = g_heapAllocations;
+    for (auto _ : state) {
+        (void)_;
+        ContainerT v(static_cast<size_t>(state.range(0)), sbo::default_init);
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
 }
 
 template<typename ContainerT>
 static void DefaultConstruct(benchmark::State& state) {
 
+    const size_t allocations = g_heapAllocations;
     for (auto _ : state) {
         (void)_;
         ContainerT v;
         benchmark::DoNotOptimize(v.data());
         benchmark::ClobberMemory();
     }
+    report_allocations(state, allocations);
 }
 
 template<typename ContainerT>
 static void EmplaceBack(benchmark::State& state) {
 
+    const size_t allocations = g_heapAllocations;
     for (auto _ : state) {
         (void)_;
         state.PauseTiming();
@@ -44,11 +108,13 @@ static void EmplaceBack(benchmark::State& state) {
         benchmark::DoNotOptimize(v.data());
         benchmark::ClobberMemory();
     }
+    report_allocations(state, allocations);
 }
 
 template<typename ContainerT>
 static void EmplaceBackReserve(benchmark::State& state) {
 
+    const size_t allocations = g_heapAllocations;
     for (auto _ : state) {
         (void)_;
         state.PauseTiming();
@@ -60,12 +126,14 @@ static void EmplaceBackReserve(benchmark::State& state) {
         benchmark::DoNotOptimize(v.data());
         benchmark::ClobberMemory();
     }
+    report_allocations(state, allocations);
 }
 
 template<typename ContainerT>
 static void RandomSortedInsertion(benchmark::State& state) {
     static std::mt19937 generator;
     static std::uniform_int_distribution<std::size_t> distribution;
+    const size_t allocations = g_heapAllocations;
     for (auto _ : state) {
         (void)_;
         state.PauseTiming();
@@ -79,8 +147,243 @@ static void RandomSortedInsertion(benchmark::State& state) {
         }
         benchmark::ClobberMemory();
     }
+    report_allocations(state, allocations);
+}
+
+//inserts every element in the middle, so half of the elements are shifted on each insert
+template<typename ContainerT>
+static void InsertMiddle(benchmark::State& state) {
+    const size_t allocations = g_heapAllocations;
+    for (auto _ : state) {
+        (void)_;
+        ContainerT v;
+        for (std::size_t i = 0; i < static_cast<size_t>(state.range(0)); ++i)
+            v.insert(v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2), typename ContainerT::value_type{});
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+
+//erases the elements one by one from the front, so all following elements are shifted on each erase
+template<typename ContainerT>
+static void EraseFront(benchmark::State& state) {
+    const size_t allocations = g_heapAllocations;
+    for (auto _ : state) {
+        (void)_;
+        ContainerT v;
+        v.resize(static_cast<size_t>(state.range(0)));
+        benchmark::DoNotOptimize(v.data());
+        while (!v.empty())
+            v.erase(v.begin());
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+
+template<typename ContainerT>
+static void MoveConstruct(benchmark::State& state) {
+    ContainerT v(static_cast<size_t>(state.range(0)));
+    const size_t allocations = g_heapAllocations;
+    for (auto _ : state) {
+        (void)_;
+        ContainerT moved(std::move(v));
+        benchmark::DoNotOptimize(moved.data());
+        v = std::move(moved);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+
+//hands a vector over to a vector with a different N and back (pipeline stages with different N)
+template<typename FromT, typename ToT>
+static void MoveAcrossN(benchmark::State& state) {
+    FromT v(static_cast<size_t>(state.range(0)));
+    const size_t allocations = g_heapAllocations;
+    for (auto _ : state) {
+        (void)_;
+        ToT moved(std::move(v));
+        benchmark::DoNotOptimize(moved.data());
+        v = std::move(moved);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
 }
 
+template<typename ContainerT>
+static void Swap(benchmark::State& state) {
+    ContainerT a(static_cast<size_t>(state.range(0)));
+    ContainerT b(static_cast<size_t>(state.range(0)) / 2);
+    const size_t allocations = g_heapAllocations;
+    for (auto _ : state) {
+        (void)_;
+        using std::swap;
+        swap(a, b);
+        benchmark::DoNotOptimize(a.data());
+        benchmark::DoNotOptimize(b.data());
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+
+//sorts range(0) random integers, sbo::sort uses a sorting network while the size doesn't exceed N
+template<typename VecT, bool UseNetwork>
+static void SortSmall(benchmark::State& state) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution;
+    std::vector<int> input(1024 * static_cast<size_t>(state.range(0)));
+    std::generate(input.begin(), input.end(), [&] { return distribution(generator); });
+    const auto size = static_cast<std::ptrdiff_t>(state.range(0));
+    auto first = input.begin();
+    VecT vec;
+    for (auto _ : state) {
+        (void)_;
+        if (first == input.end())
+            first = input.begin();
+        vec.clear();
+        vec.insert(vec.end(), first, first + size);
+        first += size;
+        if constexpr (UseNetwork)
+            sbo::sort(vec);
+        else
+            std::sort(vec.begin(), vec.end());
+        benchmark::DoNotOptimize(vec.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+//looks up all keys of a map with range(0) random keys
+template<typename MapT>
+static void MapLookup(benchmark::State& state) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution;
+    MapT map;
+    std::vector<int> keys;
+    while (map.size() < static_cast<size_t>(state.range(0))) {
+        const int key = distribution(generator);
+        if (map.insert({key, key}).second)
+            keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), generator);
+    for (auto _ : state) {
+        (void)_;
+        int sum = 0;
+        for (const int key : keys)
+            sum += map.find(key)->second;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+//searches every element and one missing value, with std::find or the SIMD kernels of sbo::find
+template<class VecT, bool UseSimd>
+static void Find(benchmark::State& state) {
+    using T = typename VecT::value_type;
+    VecT vec;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        vec.push_back(static_cast<T>(i));
+    for (auto _ : state) {
+        (void)_;
+        size_t sum = 0;
+        for (int64_t i = 0; i <= state.range(0); ++i) {
+            const T value = static_cast<T>(i);
+            benchmark::DoNotOptimize(vec.data());
+            if constexpr (UseSimd)
+                sum += static_cast<size_t>(sbo::find(vec, value) - vec.begin());
+            else
+                sum += static_cast<size_t>(std::find(vec.begin(), vec.end(), value) - vec.begin());
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * (state.range(0) + 1));
+}
+
+//every thread fills vectors past their small buffer and destroys them again, so all threads hit the heap at once
+template<class VecT>
+static void SpillMultiThreaded(benchmark::State& state) {
+    const size_t allocations = g_heapAllocations;
+    for (auto _ : state) {
+        (void)_;
+        VecT vec;
+        for (int i = 0; i < state.range(0); ++i)
+            vec.push_back(i);
+        benchmark::DoNotOptimize(vec.data());
+    }
+    report_allocations(state, allocations);
+}
+
+//every thread pushes to and pops from its own vector, but the vectors are neighbours in one array. Unless every
+//vector has its own cache lines, the threads invalidate each other's lines (false sharing).
+template<class VecT>
+static void NeighbourPushPop(benchmark::State& state) {
+    static std::array<VecT, 16> vectors;
+    VecT& vec = vectors[static_cast<size_t>(state.thread_index()) % vectors.size()];
+    for (auto _ : state) {
+        (void)_;
+        vec.push_back(1);
+        benchmark::DoNotOptimize(vec.data());
+        vec.pop_back();
+    }
+}
+
+//forwards to std::allocator and counts the heap allocations, so benchmarks can report reallocations
+static size_t g_allocations = 0;
+template<typename T>
+struct counting_allocator {
+    using value_type = T;
+    counting_allocator() noexcept = default;
+    template<typename U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+    T* allocate(size_t n) { ++g_allocations; return std::allocator<T>().allocate(n); }
+    void deallocate(T* p, size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+    friend bool operator==(const counting_allocator&, const counting_allocator&) { return true; }
+    friend bool operator!=(const counting_allocator&, const counting_allocator&) { return false; }
+};
+//counts the allocations and reallocations of malloc_allocator, without UseSlack the container only gets the 
+//requested capacity instead of the usable size of the malloc block
+template<typename T, bool UseSlack>
+struct counting_malloc_allocator : sbo::malloc_allocator<T> {
+    using base = sbo::malloc_allocator<T>;
+    template<typename U>
+    struct rebind { using other = counting_malloc_allocator<U, UseSlack>; };
+    counting_malloc_allocator() noexcept = default;
+    template<typename U>
+    counting_malloc_allocator(const counting_malloc_allocator<U, UseSlack>&) noexcept {}
+    T* allocate(size_t n) { ++g_allocations; return base::allocate(n); }
+    sbo::allocation_result<T*> allocate_at_least(size_t n) {
+        ++g_allocations;
+        if constexpr (UseSlack)
+            return base::allocate_at_least(n);
+        else
+            return {base::allocate(n), n};
+    }
+    sbo::allocation_result<T*> reallocate(T* p, size_t oldN, size_t newN) {
+        ++g_allocations;
+        auto result = base::reallocate(p, oldN, newN);
+        if constexpr (!UseSlack)
+            result.count = newN;
+        return result;
+    }
+};
+template<typename GrowthPolicy>
+using growth_small_vector = sbo::small_vector<int, 8, counting_allocator<int>, size_t, sbo::never_shrink, GrowthPolicy>;
+
+template<typename ContainerT>
+static void EmplaceBackGrowth(benchmark::State& state) {
+    g_allocations = 0;
+    const size_t allocations = g_heapAllocations;
+    for (auto _ : state) {
+        (void)_;
+        ContainerT v;
+        for (int j = 0; j < state.range(0); ++j)
+            v.emplace_back();
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+    state.counters["reallocations"] = benchmark::Counter(static_cast<double>(g_allocations), benchmark::Counter::kAvgIterations);
+}
 
 BENCHMARK_TEMPLATE(DefaultConstruct, std::vector<int>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(DefaultConstruct, sbo::small_vector<int, 8>)->RangeMultiplier(2)->Range(8, 256);
@@ -91,6 +394,10 @@ BENCHMARK_TEMPLATE(ConstructWithSize, std::vector<int>)->RangeMultiplier(2)->Ran
 BENCHMARK_TEMPLATE(ConstructWithSize, sbo::small_vector<int, 8>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(ConstructWithSize, llvm_vecsmall::SmallVector<int, 8>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(ConstructWithSize, sbo::small_vector<int, 16>)->RangeMultiplier(2)->Range(8, 256);
+BENCHMARK_TEMPLATE(ConstructWithSize, sbo::small_vector<int, 8>)->RangeMultiplier(8)->Range(512, 1 << 15);
+BENCHMARK_TEMPLATE(ConstructWithSizeForOverwrite, sbo::small_vector<int, 8>)->RangeMultiplier(2)->Range(8, 256);
+BENCHMARK_TEMPLATE(ConstructWithSizeForOverwrite, sbo::small_vector<int, 16>)->RangeMultiplier(2)->Range(8, 256);
+BENCHMARK_TEMPLATE(ConstructWithSizeForOverwrite, sbo::small_vector<int, 8>)->RangeMultiplier(8)->Range(512, 1 << 15);
 
 BENCHMARK_TEMPLATE(ConstructWithSize, std::vector<std::string>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(ConstructWithSize, llvm_vecsmall::SmallVector<int, 8>)->RangeMultiplier(2)->Range(8, 256);
@@ -101,6 +408,9 @@ BENCHMARK_TEMPLATE(EmplaceBack, std::vector<int>)->RangeMultiplier(2)->Range(8,
 BENCHMARK_TEMPLATE(EmplaceBack, sbo::small_vector<int, 8>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(EmplaceBack, llvm_vecsmall::SmallVector<int, 8>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(EmplaceBack, sbo::small_vector<int, 16>)->RangeMultiplier(2)->Range(8, 256);
+//all elements fit into the small buffer, only the inlined fast path of emplace_back is used
+BENCHMARK_TEMPLATE(EmplaceBack, sbo::small_vector<int, 64>)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(EmplaceBack, llvm_vecsmall::SmallVector<int, 64>)->RangeMultiplier(2)->Range(4, 64);
 
 BENCHMARK_TEMPLATE(EmplaceBackReserve, std::vector<int>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(EmplaceBackReserve, sbo::small_vector<int, 8>)->RangeMultiplier(2)->Range(8, 256);
@@ -116,5 +426,60 @@ BENCHMARK_TEMPLATE(RandomSortedInsertion, std::vector<size_t>)->RangeMultiplier(
 BENCHMARK_TEMPLATE(RandomSortedInsertion, sbo::small_vector<size_t, 8>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(RandomSortedInsertion, llvm_vecsmall::SmallVector<size_t, 8>)->RangeMultiplier(2)->Range(8, 256);
 BENCHMARK_TEMPLATE(RandomSortedInsertion, sbo::small_vector<size_t, 16>)->RangeMultiplier(2)->Range(8, 256);
+BENCHMARK_TEMPLATE(InsertMiddle, std::vector<size_t>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(InsertMiddle, sbo::small_vector<size_t, 16>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(InsertMiddle, llvm_vecsmall::SmallVector<size_t, 16>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(InsertMiddle, std::vector<std::unique_ptr<int>>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(InsertMiddle, sbo::small_vector<std::unique_ptr<int>, 16>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(InsertMiddle, llvm_vecsmall::SmallVector<std::unique_ptr<int>, 16>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(EraseFront, std::vector<size_t>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(EraseFront, sbo::small_vector<size_t, 16>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(EraseFront, llvm_vecsmall::SmallVector<size_t, 16>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(EraseFront, std::vector<std::unique_ptr<int>>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(EraseFront, sbo::small_vector<std::unique_ptr<int>, 16>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(EraseFront, llvm_vecsmall::SmallVector<std::unique_ptr<int>, 16>)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK_TEMPLATE(MoveConstruct, std::vector<int>)->RangeMultiplier(2)->Range(4, 16);
+BENCHMARK_TEMPLATE(MoveConstruct, sbo::small_vector<int, 16>)->RangeMultiplier(2)->Range(4, 16);
+BENCHMARK_TEMPLATE(MoveConstruct, llvm_vecsmall::SmallVector<int, 16>)->RangeMultiplier(2)->Range(4, 16);
+BENCHMARK_TEMPLATE(MoveConstruct, sbo::small_vector<std::unique_ptr<int>, 16>)->RangeMultiplier(2)->Range(4, 16);
+BENCHMARK_TEMPLATE(MoveConstruct, sbo::small_vector<sbo::small_vector<int, 4>, 16>)->RangeMultiplier(2)->Range(4, 16);
+BENCHMARK_TEMPLATE(MoveAcrossN, sbo::small_vector<int, 8>, sbo::small_vector<int, 16>)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK_TEMPLATE(MoveAcrossN, llvm_vecsmall::SmallVector<int, 8>, llvm_vecsmall::SmallVector<int, 16>)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK_TEMPLATE(MoveAcrossN, sbo::small_vector<std::string, 8>, sbo::small_vector<std::string, 16>)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK_TEMPLATE(Swap, std::vector<int>)->RangeMultiplier(4)->Range(4, 64);
+BENCHMARK_TEMPLATE(Swap, sbo::small_vector<int, 16>)->RangeMultiplier(4)->Range(4, 64);
+BENCHMARK_TEMPLATE(Swap, llvm_vecsmall::SmallVector<int, 16>)->RangeMultiplier(4)->Range(4, 64);
+BENCHMARK_TEMPLATE(Swap, sbo::small_vector<std::string, 16>)->RangeMultiplier(4)->Range(4, 64);
+BENCHMARK_TEMPLATE(MapLookup, std::map<int, int>)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(MapLookup, sbo::small_flat_map<int, int, 16>)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(MapLookup, sbo::small_flat_map<int, int, 64>)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(Find, sbo::small_vector<int, 64>, false)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(Find, sbo::small_vector<int, 64>, true)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(Find, sbo::small_vector<int, 8>, false)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK_TEMPLATE(Find, sbo::small_vector<int, 8>, true)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK_TEMPLATE(Find, sbo::small_vector<uint8_t, 64>, false)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(Find, sbo::small_vector<uint8_t, 64>, true)->RangeMultiplier(2)->Range(4, 64);
+BENCHMARK_TEMPLATE(SortSmall, std::vector<int>, false)->DenseRange(4, 16, 4)->Arg(32);
+BENCHMARK_TEMPLATE(SortSmall, llvm_vecsmall::SmallVector<int, 32>, false)->DenseRange(4, 16, 4)->Arg(32);
+BENCHMARK_TEMPLATE(SortSmall, sbo::small_vector<int, 32>, false)->DenseRange(4, 16, 4)->Arg(32);
+BENCHMARK_TEMPLATE(SortSmall, sbo::small_vector<int, 32>, true)->DenseRange(4, 16, 4)->Arg(32);
+BENCHMARK_TEMPLATE(SortSmall, sbo::small_vector<int, 16>, true)->DenseRange(4, 16, 4);
+BENCHMARK_TEMPLATE(SpillMultiThreaded, sbo::small_vector<int, 8>)->Arg(64)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(SpillMultiThreaded, sbo::small_vector<int, 8, sbo::thread_cache_allocator<int>>)->Arg(64)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(SpillMultiThreaded, std::vector<int, sbo::small_buffer_vector_allocator<int, 8>>)->Arg(64)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(SpillMultiThreaded, std::vector<int, sbo::small_buffer_vector_allocator<int, 8, sbo::thread_cache_allocator<int>>>)->Arg(64)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(NeighbourPushPop, sbo::small_vector<int, 8>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(NeighbourPushPop, sbo::small_vector_bytes<int>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(EmplaceBackGrowth, std::vector<int, counting_allocator<int>>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK_TEMPLATE(EmplaceBackGrowth, growth_small_vector<sbo::grow_double>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK_TEMPLATE(EmplaceBackGrowth, growth_small_vector<sbo::grow_one_and_a_half>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK_TEMPLATE(EmplaceBackGrowth, growth_small_vector<sbo::grow_by<64>>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK_TEMPLATE(EmplaceBackGrowth, growth_small_vector<sbo::grow_to_size_class>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK_TEMPLATE(EmplaceBackGrowth, growth_small_vector<sbo::grow_to_page_multiple<>>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK_TEMPLATE(EmplaceBackGrowth, sbo::small_vector<int, 8, counting_malloc_allocator<int, false>>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK_TEMPLATE(EmplaceBackGrowth, sbo::small_vector<int, 8, counting_malloc_allocator<int, true>>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK_TEMPLATE(EmplaceBack, std::vector<int>)->RangeMultiplier(16)->Range(4096, 1 << 22);
+BENCHMARK_TEMPLATE(EmplaceBack, sbo::small_vector<int, 8>)->RangeMultiplier(16)->Range(4096, 1 << 22);
+BENCHMARK_TEMPLATE(EmplaceBack, sbo::small_vector<int, 8, sbo::malloc_allocator<int>>)->RangeMultiplier(16)->Range(4096, 1 << 22);
 // Run the benchmark
 BENCHMARK_MAIN();
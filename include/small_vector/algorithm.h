@@ -0,0 +1,75 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#pragma once
+#include <small_vector/simd.h>
+#include <small_vector/small_vector.h>
+#include <small_vector/sorting_network.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace sbo{
+
+    namespace detail {
+        //std::type_identity_t of C++20, keeps a parameter out of the template argument deduction
+        template<typename T>
+        struct type_identity {
+            using type = T;
+        };
+        template<typename T>
+        using type_identity_t = typename type_identity<T>::type;
+    }
+
+    //Searches for integers and floating point numbers compare whole SSE2/AVX2 registers at once (see detail::simd).
+    //While the elements are in the small buffer, the buffer is searched with whole vectors only, as N is known at
+    //compile time. Other element types use the std algorithms.
+    //Floating point numbers are compared with ==, so NaN is never found and -0.0 equals 0.0.
+    //value doesn't take part in the deduction, so e.g. contains(small_vector<long>, 2) converts 2 to long.
+
+    //index of the first element equal to value, vec.size() if there is none
+    template<typename T, size_t N, typename... Params>
+    size_t index_of(const small_vector<T, N, Params...>& vec, const detail::type_identity_t<T>& value) {
+        if constexpr (detail::simd::is_simd_arithmetic_v<T>) {
+            if (vec.is_small())
+                return detail::simd::find_index_in_buffer<N>(vec.data(), vec.size(), value);
+            return detail::simd::find_index(vec.data(), vec.size(), value);
+        } else {
+            return static_cast<size_t>(std::find(vec.begin(), vec.end(), value) - vec.begin());
+        }
+    }
+    template<typename T, size_t N, typename... Params>
+    typename small_vector<T, N, Params...>::iterator find(small_vector<T, N, Params...>& vec, const detail::type_identity_t<T>& value) {
+        return vec.begin() + index_of(vec, value);
+    }
+    template<typename T, size_t N, typename... Params>
+    typename small_vector<T, N, Params...>::const_iterator find(const small_vector<T, N, Params...>& vec, const detail::type_identity_t<T>& value) {
+        return vec.begin() + index_of(vec, value);
+    }
+    template<typename T, size_t N, typename... Params>
+    bool contains(const small_vector<T, N, Params...>& vec, const detail::type_identity_t<T>& value) {
+        return index_of(vec, value) != vec.size();
+    }
+    template<typename T, size_t N, typename... Params>
+    size_t count(const small_vector<T, N, Params...>& vec, const detail::type_identity_t<T>& value) {
+        if constexpr (detail::simd::is_simd_arithmetic_v<T>) {
+            if (vec.is_small())
+                return detail::simd::count_equal_in_buffer<N>(vec.data(), vec.size(), value);
+            return detail::simd::count_equal(vec.data(), vec.size(), value);
+        } else {
+            return static_cast<size_t>(std::count(vec.begin(), vec.end(), value));
+        }
+    }
+
+    //Sorts with the sorting network for exactly size() elements while size() <= N and N <= 32 (see detail::network),
+    //otherwise with std::sort. Like std::sort it isn't stable.
+    template<typename T, size_t N, typename... Params, typename Compare = std::less<>>
+    void sort(small_vector<T, N, Params...>& vec, Compare comp = Compare()) {
+        if constexpr (N <= detail::network::max_size) {
+            if (vec.size() <= N) {
+                detail::network::sort<N>(vec.data(), vec.size(), comp);
+                return;
+            }
+        }
+        std::sort(vec.begin(), vec.end(), comp);
+    }
+}
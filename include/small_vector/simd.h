@@ -0,0 +1,320 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+//The kernels use AVX2 when the compiler targets it (e.g. -mavx2 or /arch:AVX2) and SSE2 otherwise, which is part
+//of every x86-64 target. Define SBO_DISABLE_SIMD to always use the scalar loops.
+#if !defined(SBO_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define SBO_SIMD_SSE2 1
+#  include <emmintrin.h>
+#else
+#  define SBO_SIMD_SSE2 0
+#endif
+#if SBO_SIMD_SSE2 && defined(__AVX2__)
+#  define SBO_SIMD_AVX2 1
+#  include <immintrin.h>
+#else
+#  define SBO_SIMD_AVX2 0
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
+namespace sbo{
+
+    //Kernels for arithmetic element types, which compare a whole vector register at once. The remaining elements
+    //(and all elements when SIMD isn't available) are handled by a scalar loop.
+    namespace detail::simd {
+        constexpr int popcount(unsigned x) noexcept {
+            x = x - ((x >> 1) & 0x55555555u);
+            x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+            return static_cast<int>((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+        }
+        //requires x != 0
+        inline int countr_zero(unsigned x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(x);
+#elif defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, x);
+            return static_cast<int>(index);
+#else
+            int count = 0;
+            for (; (x & 1u) == 0; x >>= 1)
+                ++count;
+            return count;
+#endif
+        }
+
+        template<typename T>
+        constexpr bool is_simd_arithmetic_v = std::is_same_v<T, float> || std::is_same_v<T, double>
+            || (std::is_integral_v<T> && !std::is_same_v<T, bool>);
+
+        //flips the sign bit of unsigned integers, so that the signed comparisons keep their order
+        template<typename T>
+        constexpr T sign_bit() noexcept { return static_cast<T>(T(1) << (sizeof(T) * 8 - 1)); }
+
+#if SBO_SIMD_SSE2
+        struct sse2 {
+            using reg = __m128i;
+            static constexpr size_t bytes = 16;
+            template<typename T>
+            static constexpr bool has_equal = is_simd_arithmetic_v<T>;
+            //64 bit integers can only be ordered with SSE4.2
+            template<typename T>
+            static constexpr bool has_less = is_simd_arithmetic_v<T> && (std::is_floating_point_v<T> || sizeof(T) <= 4);
+
+            template<typename T>
+            static reg broadcast(T value) noexcept {
+                if constexpr (std::is_same_v<T, float>)
+                    return _mm_castps_si128(_mm_set1_ps(value));
+                else if constexpr (std::is_same_v<T, double>)
+                    return _mm_castpd_si128(_mm_set1_pd(value));
+                else if constexpr (sizeof(T) == 1)
+                    return _mm_set1_epi8(static_cast<char>(value));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_set1_epi16(static_cast<short>(value));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm_set1_epi32(static_cast<int>(value));
+                else
+                    return _mm_set1_epi64x(static_cast<long long>(value));
+            }
+            template<typename T>
+            static reg load(const T* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+            //byte masks (_mm_movemask_epi8), every lane sets sizeof(T) bits
+            template<typename T>
+            static unsigned equal_mask(reg a, reg b) noexcept {
+                if constexpr (std::is_same_v<T, float>) {
+                    return mask(_mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b))));
+                } else if constexpr (std::is_same_v<T, double>) {
+                    return mask(_mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b))));
+                } else if constexpr (sizeof(T) == 1) {
+                    return mask(_mm_cmpeq_epi8(a, b));
+                } else if constexpr (sizeof(T) == 2) {
+                    return mask(_mm_cmpeq_epi16(a, b));
+                } else if constexpr (sizeof(T) == 4) {
+                    return mask(_mm_cmpeq_epi32(a, b));
+                } else {
+                    //both 32 bit halves have to be equal
+                    const __m128i halves = _mm_cmpeq_epi32(a, b);
+                    return mask(_mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1))));
+                }
+            }
+            template<typename T>
+            static unsigned less_mask(reg a, reg b) noexcept {
+                if constexpr (std::is_same_v<T, float>) {
+                    return mask(_mm_castps_si128(_mm_cmplt_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b))));
+                } else if constexpr (std::is_same_v<T, double>) {
+                    return mask(_mm_castpd_si128(_mm_cmplt_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b))));
+                } else {
+                    if constexpr (std::is_unsigned_v<T>) {
+                        a = _mm_xor_si128(a, broadcast(sign_bit<T>()));
+                        b = _mm_xor_si128(b, broadcast(sign_bit<T>()));
+                    }
+                    if constexpr (sizeof(T) == 1)
+                        return mask(_mm_cmplt_epi8(a, b));
+                    else if constexpr (sizeof(T) == 2)
+                        return mask(_mm_cmplt_epi16(a, b));
+                    else
+                        return mask(_mm_cmplt_epi32(a, b));
+                }
+            }
+            static unsigned mask(reg r) noexcept { return static_cast<unsigned>(_mm_movemask_epi8(r)); }
+        };
+#endif
+#if SBO_SIMD_AVX2
+        struct avx2 {
+            using reg = __m256i;
+            static constexpr size_t bytes = 32;
+            template<typename T>
+            static constexpr bool has_equal = is_simd_arithmetic_v<T>;
+            template<typename T>
+            static constexpr bool has_less = is_simd_arithmetic_v<T>;
+
+            template<typename T>
+            static reg broadcast(T value) noexcept {
+                if constexpr (std::is_same_v<T, float>)
+                    return _mm256_castps_si256(_mm256_set1_ps(value));
+                else if constexpr (std::is_same_v<T, double>)
+                    return _mm256_castpd_si256(_mm256_set1_pd(value));
+                else if constexpr (sizeof(T) == 1)
+                    return _mm256_set1_epi8(static_cast<char>(value));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm256_set1_epi16(static_cast<short>(value));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm256_set1_epi32(static_cast<int>(value));
+                else
+                    return _mm256_set1_epi64x(static_cast<long long>(value));
+            }
+            template<typename T>
+            static reg load(const T* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+
+            template<typename T>
+            static unsigned equal_mask(reg a, reg b) noexcept {
+                if constexpr (std::is_same_v<T, float>)
+                    return mask(_mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ)));
+                else if constexpr (std::is_same_v<T, double>)
+                    return mask(_mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ)));
+                else if constexpr (sizeof(T) == 1)
+                    return mask(_mm256_cmpeq_epi8(a, b));
+                else if constexpr (sizeof(T) == 2)
+                    return mask(_mm256_cmpeq_epi16(a, b));
+                else if constexpr (sizeof(T) == 4)
+                    return mask(_mm256_cmpeq_epi32(a, b));
+                else
+                    return mask(_mm256_cmpeq_epi64(a, b));
+            }
+            template<typename T>
+            static unsigned less_mask(reg a, reg b) noexcept {
+                if constexpr (std::is_same_v<T, float>) {
+                    return mask(_mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_LT_OQ)));
+                } else if constexpr (std::is_same_v<T, double>) {
+                    return mask(_mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_LT_OQ)));
+                } else {
+                    if constexpr (std::is_unsigned_v<T>) {
+                        a = _mm256_xor_si256(a, broadcast(sign_bit<T>()));
+                        b = _mm256_xor_si256(b, broadcast(sign_bit<T>()));
+                    }
+                    if constexpr (sizeof(T) == 1)
+                        return mask(_mm256_cmpgt_epi8(b, a));
+                    else if constexpr (sizeof(T) == 2)
+                        return mask(_mm256_cmpgt_epi16(b, a));
+                    else if constexpr (sizeof(T) == 4)
+                        return mask(_mm256_cmpgt_epi32(b, a));
+                    else
+                        return mask(_mm256_cmpgt_epi64(b, a));
+                }
+            }
+            static unsigned mask(reg r) noexcept { return static_cast<unsigned>(_mm256_movemask_epi8(r)); }
+        };
+        using vector_unit = avx2;
+#elif SBO_SIMD_SSE2
+        using vector_unit = sse2;
+#else
+        //no vector instructions, every kernel uses its scalar loop
+        struct vector_unit {
+            static constexpr size_t bytes = 0;
+            template<typename T>
+            static constexpr bool has_equal = false;
+            template<typename T>
+            static constexpr bool has_less = false;
+        };
+#endif
+
+        template<typename T>
+        constexpr bool has_simd_equal_v = vector_unit::template has_equal<T>;
+        template<typename T>
+        constexpr bool has_simd_less_v = vector_unit::template has_less<T>;
+
+        //Buffers of Capacity elements which are a multiple of the vector size are searched with whole vectors only,
+        //the lanes behind size are ignored. N is known at compile time for the small buffer, so there is no tail loop.
+        template<typename T, size_t Capacity>
+        constexpr bool is_whole_vector_buffer_v = has_simd_equal_v<T> && Capacity * sizeof(T) % vector_unit::bytes == 0;
+
+        //index of the first element equal to value, size if there is none
+        template<typename T>
+        size_t find_index(const T* data, size_t size, T value) noexcept {
+            size_t i = 0;
+#if SBO_SIMD_SSE2
+            if constexpr (has_simd_equal_v<T>) {
+                using V = vector_unit;
+                constexpr size_t lanes = V::bytes / sizeof(T);
+                const auto v = V::broadcast(value);
+                for (; i + lanes <= size; i += lanes) {
+                    if (const unsigned mask = V::template equal_mask<T>(V::load(data + i), v))
+                        return i + static_cast<size_t>(countr_zero(mask)) / sizeof(T);
+                }
+            }
+#endif
+            for (; i < size; ++i) {
+                if (data[i] == value)
+                    return i;
+            }
+            return size;
+        }
+        //like find_index, but data has to point to a buffer of Capacity elements
+        template<size_t Capacity, typename T>
+        size_t find_index_in_buffer(const T* data, size_t size, T value) noexcept {
+#if SBO_SIMD_SSE2
+            if constexpr (is_whole_vector_buffer_v<T, Capacity>) {
+                using V = vector_unit;
+                constexpr size_t lanes = V::bytes / sizeof(T);
+                const auto v = V::broadcast(value);
+                for (size_t i = 0; i < size; i += lanes) {
+                    if (const unsigned mask = V::template equal_mask<T>(V::load(data + i), v)) {
+                        const size_t index = i + static_cast<size_t>(countr_zero(mask)) / sizeof(T);
+                        return index < size ? index : size;
+                    }
+                }
+                return size;
+            }
+#endif
+            return find_index(data, size, value);
+        }
+
+        template<typename T>
+        size_t count_equal(const T* data, size_t size, T value) noexcept {
+            size_t count = 0;
+            size_t i = 0;
+#if SBO_SIMD_SSE2
+            if constexpr (has_simd_equal_v<T>) {
+                using V = vector_unit;
+                constexpr size_t lanes = V::bytes / sizeof(T);
+                const auto v = V::broadcast(value);
+                for (; i + lanes <= size; i += lanes)
+                    count += static_cast<size_t>(popcount(V::template equal_mask<T>(V::load(data + i), v)));
+                count /= sizeof(T);
+            }
+#endif
+            for (; i < size; ++i)
+                count += static_cast<size_t>(data[i] == value);
+            return count;
+        }
+        template<size_t Capacity, typename T>
+        size_t count_equal_in_buffer(const T* data, size_t size, T value) noexcept {
+#if SBO_SIMD_SSE2
+            if constexpr (is_whole_vector_buffer_v<T, Capacity>) {
+                using V = vector_unit;
+                constexpr size_t lanes = V::bytes / sizeof(T);
+                const auto v = V::broadcast(value);
+                size_t count = 0;
+                for (size_t i = 0; i < size; i += lanes) {
+                    unsigned mask = V::template equal_mask<T>(V::load(data + i), v);
+                    //only the last vector can contain lanes behind size
+                    const size_t validBytes = (size - i) * sizeof(T);
+                    if (validBytes < V::bytes)
+                        mask &= (1u << validBytes) - 1u;
+                    count += static_cast<size_t>(popcount(mask));
+                }
+                return count / sizeof(T);
+            }
+#endif
+            return count_equal(data, size, value);
+        }
+
+        //number of elements in [data, data + size) which are less than key, without any branches on the data.
+        //For sorted data this is the index of the lower bound.
+        template<typename T>
+        size_t count_less(const T* data, size_t size, T key) noexcept {
+            size_t count = 0;
+            size_t i = 0;
+#if SBO_SIMD_SSE2
+            if constexpr (has_simd_less_v<T>) {
+                using V = vector_unit;
+                constexpr size_t lanes = V::bytes / sizeof(T);
+                const auto k = V::broadcast(key);
+                for (; i + lanes <= size; i += lanes)
+                    count += static_cast<size_t>(popcount(V::template less_mask<T>(V::load(data + i), k)));
+                count /= sizeof(T);
+            }
+#endif
+            for (; i < size; ++i)
+                count += static_cast<size_t>(data[i] < key);
+            return count;
+        }
+    }
+}
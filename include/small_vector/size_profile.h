@@ -0,0 +1,250 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#pragma once
+#include <small_vector/spill_telemetry.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#if __has_include(<source_location>)
+#  include <source_location>
+#endif
+
+//Profiling mode of small_vector, enabled by defining SBO_SIZE_PROFILING for all translation units of the program
+//(CMake option SMALL_VECTOR_SIZE_PROFILING). Every small_vector remembers the location of the code which constructed
+//it and its peak size. When it is destroyed, the peak size is added to the size distribution of that location.
+//At exit a report with the distribution and a recommended N per location is written to std::cerr.
+
+namespace sbo{
+
+    namespace detail {
+        //std::source_location needs C++20, otherwise the builtins of gcc, clang and msvc are used (without the column)
+        struct source_site {
+            const char* file = "";
+            const char* function = "";
+            uint_least32_t line = 0;
+            uint_least32_t column = 0;
+
+#if defined(__cpp_lib_source_location)
+            static constexpr source_site current(std::source_location location = std::source_location::current()) noexcept {
+                return {location.file_name(), location.function_name(), location.line(), location.column()};
+            }
+#else
+            static constexpr source_site current(const char* file = __builtin_FILE(), const char* function = __builtin_FUNCTION(),
+                                                 uint_least32_t line = __builtin_LINE()) noexcept {
+                return {file, function, line, 0};
+            }
+#endif
+        };
+
+        //the small_vector instantiation of a site
+        struct profiled_type {
+            std::string_view elementType;
+            size_t elementSize;
+            size_t inlineCapacity;
+            size_t objectSize;
+        };
+        template<typename Vec, typename T, size_t N>
+        const profiled_type& profiled_type_of() noexcept {
+            static const profiled_type type{type_name<T>(), sizeof(T), N, sizeof(Vec)};
+            return type;
+        }
+    }
+
+    //size distribution of the small_vectors constructed at one location
+    struct size_profile_site {
+        std::string_view file;
+        std::string_view function;
+        uint_least32_t line = 0;
+        uint_least32_t column = 0;
+        std::string_view elementType;
+        size_t elementSize = 0;
+        size_t inlineCapacity = 0;
+        size_t objectSize = 0;
+        //peak size -> number of small_vectors which reached it
+        std::map<size_t, uint64_t> peakSizes;
+
+        uint64_t instances() const noexcept {
+            uint64_t count = 0;
+            for (const auto& entry : peakSizes)
+                count += entry.second;
+            return count;
+        }
+        //smallest peak size which covers the given fraction of the instances
+        size_t percentile(double fraction) const noexcept {
+            const double target = fraction * static_cast<double>(instances());
+            uint64_t count = 0;
+            for (const auto& [size, n] : peakSizes) {
+                count += n;
+                if (static_cast<double>(count) >= target)
+                    return size;
+            }
+            return peakSizes.empty() ? 0 : peakSizes.rbegin()->first;
+        }
+        //fraction of the instances which needed the heap with the current N
+        double spill_rate() const noexcept {
+            uint64_t spilled = 0;
+            for (auto it = peakSizes.upper_bound(inlineCapacity); it != peakSizes.end(); ++it)
+                spilled += it->second;
+            const uint64_t count = instances();
+            return count == 0 ? 0. : static_cast<double>(spilled) / static_cast<double>(count);
+        }
+        //N which covers the fraction of the instances, as long as the inline elements fit into byteBudget
+        size_t recommended_inline_capacity(double fraction = 0.95, size_t byteBudget = 256) const noexcept {
+            const size_t maxCapacity = std::max<size_t>(byteBudget / elementSize, 1);
+            return std::clamp<size_t>(percentile(fraction), 1, maxCapacity);
+        }
+    };
+
+    namespace detail {
+        class size_profile_registry {
+        public:
+            static size_profile_registry& instance() {
+                //never destroyed, small_vectors with static storage duration might record after the exit report
+                static size_profile_registry* registry = [] {
+                    auto* created = new size_profile_registry();
+                    std::atexit([] { instance().write_exit_report(); });
+                    return created;
+                }();
+                return *registry;
+            }
+
+            void add(const source_site& site, const profiled_type& type, size_t peakSize) {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                size_profile_site& entry = m_sites[key{site.file, site.line, site.column, &type}];
+                if (entry.peakSizes.empty()) {
+                    entry.file = site.file;
+                    entry.function = site.function;
+                    entry.line = site.line;
+                    entry.column = site.column;
+                    entry.elementType = type.elementType;
+                    entry.elementSize = type.elementSize;
+                    entry.inlineCapacity = type.inlineCapacity;
+                    entry.objectSize = type.objectSize;
+                }
+                ++entry.peakSizes[peakSize];
+            }
+            std::vector<size_profile_site> sites() const {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                std::vector<size_profile_site> result;
+                for (const auto& entry : m_sites)
+                    result.push_back(entry.second);
+                return result;
+            }
+            void reset() {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                m_sites.clear();
+            }
+            void set_exit_report(std::ostream* out, double fraction, size_t byteBudget) {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                m_exitReport = out;
+                m_fraction = fraction;
+                m_byteBudget = byteBudget;
+            }
+
+        private:
+            using key = std::tuple<std::string_view, uint_least32_t, uint_least32_t, const profiled_type*>;
+
+            void write_exit_report();
+
+            mutable std::mutex m_mutex;
+            std::map<key, size_profile_site> m_sites;
+            std::ostream* m_exitReport = &std::cerr;
+            double m_fraction = 0.95;
+            size_t m_byteBudget = 256;
+        };
+
+        //base class of small_vector in the profiling mode, a vector keeps the site of its constructor
+        //(copies and moves are attributed to the site which constructed them)
+        class size_profile {
+        public:
+            explicit size_profile(const source_site& site) noexcept : m_site(site) {}
+            size_profile(const size_profile&) = delete;
+            size_profile& operator=(const size_profile&) = delete;
+
+            void note_size(size_t size) noexcept { m_peakSize = std::max(m_peakSize, size); }
+            template<typename Vec, typename T, size_t N>
+            void record(size_t size) noexcept {
+                note_size(size);
+                try {
+                    size_profile_registry::instance().add(m_site, profiled_type_of<Vec, T, N>(), m_peakSize);
+                } catch (...) {
+                    //profiling must not terminate the program when the registry runs out of memory
+                }
+            }
+
+        private:
+            source_site m_site;
+            size_t m_peakSize = 0;
+        };
+    }
+
+    //the size distributions of all sites so far
+    inline std::vector<size_profile_site> size_profile() { return detail::size_profile_registry::instance().sites(); }
+    inline void reset_size_profile() { detail::size_profile_registry::instance().reset(); }
+
+    //one line per site, sorted by the number of instances:
+    //file:line function: small_vector<T, N> instances, p50/p95/max of the peak sizes, spill rate and recommended N,
+    //followed by the log2 histogram of the peak sizes
+    inline void write_size_profile_report(std::ostream& out, double fraction = 0.95, size_t byteBudget = 256) {
+        std::vector<size_profile_site> sites = size_profile();
+        std::stable_sort(sites.begin(), sites.end(), [](const size_profile_site& lhs, const size_profile_site& rhs) {
+            return lhs.instances() > rhs.instances();
+        });
+        out << "sbo::small_vector size profile: recommended N covers the p" << fraction * 100 << " of the peak sizes with at most "
+            << byteBudget << " bytes of inline elements\n";
+        for (const size_profile_site& site : sites) {
+            const size_t recommended = site.recommended_inline_capacity(fraction, byteBudget);
+            out << site.file << ':' << site.line;
+            if (site.column != 0)
+                out << ':' << site.column;
+            out << ' ' << site.function << ": small_vector<" << site.elementType << ", " << site.inlineCapacity << "> ("
+                << site.objectSize << " bytes) instances: " << site.instances() << ", peak size p50: " << site.percentile(0.5)
+                << ", p95: " << site.percentile(0.95) << ", max: " << site.percentile(1.) << ", spilled: "
+                << site.spill_rate() * 100 << "%, recommended N: " << recommended << " ("
+                << recommended * site.elementSize << " bytes)\n  peak sizes:";
+            //buckets [0], [1], [2, 3], [4, 7], ...
+            std::map<size_t, uint64_t> buckets;
+            for (const auto& [size, count] : site.peakSizes) {
+                size_t first = size == 0 ? 0 : 1;
+                while (first != 0 && first <= size / 2)
+                    first *= 2;
+                buckets[first] += count;
+            }
+            for (const auto& [first, count] : buckets) {
+                const size_t last = first <= 1 ? first : first * 2 - 1;
+                out << ' ' << first;
+                if (last != first)
+                    out << '-' << last;
+                out << ": " << count;
+            }
+            out << '\n';
+        }
+    }
+
+    //where the report is written at exit (nullptr disables it), by default std::cerr, p95 and 256 bytes
+    inline void set_size_profile_exit_report(std::ostream* out, double fraction = 0.95, size_t byteBudget = 256) {
+        detail::size_profile_registry::instance().set_exit_report(out, fraction, byteBudget);
+    }
+
+    inline void detail::size_profile_registry::write_exit_report() {
+        std::ostream* out = nullptr;
+        double fraction = 0;
+        size_t byteBudget = 0;
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            out = m_sites.empty() ? nullptr : m_exitReport;
+            fraction = m_fraction;
+            byteBudget = m_byteBudget;
+        }
+        if (out)
+            write_size_profile_report(*out, fraction, byteBudget);
+    }
+}
@@ -0,0 +1,241 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#pragma once
+#include <small_vector/small_flat_set.h>
+
+#include <stdexcept>
+#include <tuple>
+
+namespace sbo{
+
+    //Sorted map with unique keys. Keys and values are stored in two small_vectors (like std::flat_map), so the keys
+    //are contiguous and lookups of arithmetic keys can scan the small buffer with SIMD instructions. Larger maps
+    //use a binary search. The iterators return a std::pair<const K&, V&> proxy instead of a reference to a pair.
+    template<typename K, typename V, size_t N = 8, typename Compare = std::less<K>,
+             typename Alloc = std::allocator<std::pair<const K, V>>>
+    class small_flat_map : private detail::compare_holder<Compare> {
+        using compare_holder = detail::compare_holder<Compare>;
+        using alloc_traits = std::allocator_traits<Alloc>;
+    public:
+        using key_container_type = small_vector<K, N, typename alloc_traits::template rebind_alloc<K>>;
+        using mapped_container_type = small_vector<V, N, typename alloc_traits::template rebind_alloc<V>>;
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using key_compare = Compare;
+        using allocator_type = Alloc;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template<bool Const>
+        class basic_iterator {
+            using mapped_ref = std::conditional_t<Const, const V&, V&>;
+            using mapped_ptr = std::conditional_t<Const, const V*, V*>;
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::pair<K, V>;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::pair<const K&, mapped_ref>;
+            struct pointer {
+                reference ref;
+                const reference* operator->() const noexcept { return &ref; }
+            };
+
+            basic_iterator() noexcept = default;
+            basic_iterator(const K* key, mapped_ptr value) noexcept : m_key(key), m_value(value) {}
+            template<bool C = Const, typename = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& other) noexcept : m_key(other.key_ptr()), m_value(other.value_ptr()) {}
+
+            reference operator*() const noexcept { return {*m_key, *m_value}; }
+            pointer operator->() const noexcept { return {**this}; }
+            reference operator[](difference_type n) const noexcept { return {m_key[n], m_value[n]}; }
+
+            basic_iterator& operator++() noexcept { ++m_key; ++m_value; return *this; }
+            basic_iterator operator++(int) noexcept { basic_iterator it = *this; ++*this; return it; }
+            basic_iterator& operator--() noexcept { --m_key; --m_value; return *this; }
+            basic_iterator operator--(int) noexcept { basic_iterator it = *this; --*this; return it; }
+            basic_iterator& operator+=(difference_type n) noexcept { m_key += n; m_value += n; return *this; }
+            basic_iterator& operator-=(difference_type n) noexcept { m_key -= n; m_value -= n; return *this; }
+            friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept { return it += n; }
+            friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept { return it += n; }
+            friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept { return it -= n; }
+            friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.m_key - rhs.m_key; }
+
+            friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.m_key == rhs.m_key; }
+            friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.m_key != rhs.m_key; }
+            friend bool operator<(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.m_key < rhs.m_key; }
+            friend bool operator>(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return rhs < lhs; }
+            friend bool operator<=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return !(rhs < lhs); }
+            friend bool operator>=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return !(lhs < rhs); }
+
+            const K* key_ptr() const noexcept { return m_key; }
+            mapped_ptr value_ptr() const noexcept { return m_value; }
+        private:
+            const K* m_key = nullptr;
+            mapped_ptr m_value = nullptr;
+        };
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        small_flat_map() = default;
+        explicit small_flat_map(const Compare& comp, const Alloc& alloc = Alloc())
+            : compare_holder(comp), m_keys(alloc), m_values(alloc) {}
+        explicit small_flat_map(const Alloc& alloc) : m_keys(alloc), m_values(alloc) {}
+        template<class InputIt, typename = detail::enable_if_iterator_t<InputIt>>
+        small_flat_map(InputIt first, InputIt last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : small_flat_map(comp, alloc) {
+            insert(first, last);
+        }
+        small_flat_map(std::initializer_list<value_type> init, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : small_flat_map(init.begin(), init.end(), comp, alloc) {}
+        small_flat_map& operator=(std::initializer_list<value_type> init) {
+            clear();
+            insert(init.begin(), init.end());
+            return *this;
+        }
+
+        iterator begin() noexcept { return {m_keys.data(), m_values.data()}; }
+        const_iterator begin() const noexcept { return {m_keys.data(), m_values.data()}; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        iterator end() noexcept { return begin() + static_cast<difference_type>(size()); }
+        const_iterator end() const noexcept { return begin() + static_cast<difference_type>(size()); }
+        const_iterator cend() const noexcept { return end(); }
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        [[nodiscard]] bool empty() const noexcept { return m_keys.empty(); }
+        size_type size() const noexcept { return m_keys.size(); }
+        size_type max_size() const noexcept { return std::min(m_keys.max_size(), m_values.max_size()); }
+        size_type capacity() const noexcept { return std::min(m_keys.capacity(), m_values.capacity()); }
+        void reserve(size_type newCapacity) {
+            m_keys.reserve(newCapacity);
+            m_values.reserve(newCapacity);
+        }
+        void shrink_to_fit() {
+            m_keys.shrink_to_fit();
+            m_values.shrink_to_fit();
+        }
+        void clear() noexcept {
+            m_keys.clear();
+            m_values.clear();
+        }
+        //the sorted keys and the values in the same order
+        const key_container_type& keys() const noexcept { return m_keys; }
+        const mapped_container_type& values() const noexcept { return m_values; }
+        key_compare key_comp() const { return this->comp(); }
+        allocator_type get_allocator() const noexcept { return Alloc(m_keys.get_allocator()); }
+
+        V& operator[](const K& key) { return try_emplace(key).first->second; }
+        V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+        V& at(const K& key) {
+            const iterator it = find(key);
+            if (it == end())
+                throw std::out_of_range("sbo::small_flat_map::at");
+            return it->second;
+        }
+        const V& at(const K& key) const {
+            const const_iterator it = find(key);
+            if (it == end())
+                throw std::out_of_range("sbo::small_flat_map::at");
+            return it->second;
+        }
+
+        template<class... Args>
+        std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) { return try_emplace_key(key, std::forward<Args>(args)...); }
+        template<class... Args>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) { return try_emplace_key(std::move(key), std::forward<Args>(args)...); }
+        template<class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            value_type value(std::forward<Args>(args)...);
+            return try_emplace(std::move(value.first), std::move(value.second));
+        }
+        std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+        std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(std::move(value.first), std::move(value.second)); }
+        template<class InputIt, typename = detail::enable_if_iterator_t<InputIt>>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first)
+                emplace(*first);
+        }
+        void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+        template<class M>
+        std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+            auto result = try_emplace(key, std::forward<M>(value));
+            if (!result.second)
+                result.first->second = std::forward<M>(value);
+            return result;
+        }
+
+        iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+        iterator erase(const_iterator first, const_iterator last) {
+            const auto index = first - cbegin();
+            const auto count = last - first;
+            m_keys.erase(m_keys.begin() + index, m_keys.begin() + index + count);
+            m_values.erase(m_values.begin() + index, m_values.begin() + index + count);
+            return begin() + index;
+        }
+        size_type erase(const K& key) {
+            const const_iterator it = find(key);
+            if (it == end())
+                return 0;
+            erase(it);
+            return 1;
+        }
+
+        iterator find(const K& key) { return begin() + find_index(key); }
+        const_iterator find(const K& key) const { return begin() + find_index(key); }
+        bool contains(const K& key) const { return find_index(key) != size(); }
+        size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+        iterator lower_bound(const K& key) { return begin() + lower_bound_index(key); }
+        const_iterator lower_bound(const K& key) const { return begin() + lower_bound_index(key); }
+
+        void swap(small_flat_map& other) {
+            using std::swap;
+            swap(static_cast<compare_holder&>(*this), static_cast<compare_holder&>(other));
+            m_keys.swap(other.m_keys);
+            m_values.swap(other.m_values);
+        }
+        friend void swap(small_flat_map& a, small_flat_map& b) { a.swap(b); }
+
+        friend bool operator==(const small_flat_map& lhs, const small_flat_map& rhs) {
+            return lhs.m_keys == rhs.m_keys && lhs.m_values == rhs.m_values;
+        }
+        friend bool operator!=(const small_flat_map& lhs, const small_flat_map& rhs) { return !(lhs == rhs); }
+
+    private:
+        size_type lower_bound_index(const K& key) const {
+            return detail::lower_bound_index<N>(m_keys.data(), m_keys.size(), key, this->comp());
+        }
+        //returns size() when the key isn't found
+        size_type find_index(const K& key) const {
+            const size_type index = lower_bound_index(key);
+            return index != size() && !this->comp()(key, m_keys[index]) ? index : size();
+        }
+        template<typename Key, class... Args>
+        std::pair<iterator, bool> try_emplace_key(Key&& key, Args&&... args) {
+            size_type index = size();
+            //appending sorted keys doesn't need a search
+            if (!m_keys.empty() && !this->comp()(m_keys.back(), key)) {
+                index = lower_bound_index(key);
+                if (!this->comp()(key, m_keys[index]))
+                    return {begin() + static_cast<difference_type>(index), false};
+            }
+            m_keys.emplace(m_keys.begin() + index, std::forward<Key>(key));
+            try {
+                m_values.emplace(m_values.begin() + index, std::forward<Args>(args)...);
+            } catch (...) {
+                m_keys.erase(m_keys.begin() + index);
+                throw;
+            }
+            return {begin() + static_cast<difference_type>(index), true};
+        }
+
+        key_container_type m_keys;
+        mapped_container_type m_values;
+    };
+}
@@ -0,0 +1,177 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#pragma once
+#include <small_vector/simd.h>
+#include <small_vector/small_vector.h>
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+namespace sbo{
+
+    namespace detail {
+        //empty comparators (e.g. std::less) don't take any space
+        template<typename Compare, bool = std::is_empty_v<Compare> && !std::is_final_v<Compare>>
+        struct compare_holder : private Compare {
+            compare_holder() = default;
+            explicit compare_holder(const Compare& comp) : Compare(comp) {}
+            const Compare& comp() const noexcept { return *this; }
+        };
+        template<typename Compare>
+        struct compare_holder<Compare, false> {
+            compare_holder() = default;
+            explicit compare_holder(const Compare& comp) : m_comp(comp) {}
+            const Compare& comp() const noexcept { return m_comp; }
+        private:
+            Compare m_comp{};
+        };
+
+        //arithmetic keys ordered by std::less are searched with a linear scan while they fit into the small buffer
+        template<typename K, typename Compare>
+        constexpr bool is_linear_searchable_v = std::is_arithmetic_v<K>
+            && (std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>);
+
+        //index of the first key which is not less than key. Keys in the small buffer are scanned linearly (vectorized
+        //by detail::simd), once the keys don't fit into the small buffer a binary search is used. Both don't branch
+        //on the keys, so there are no mispredictions.
+        template<size_t N, typename K, typename Compare>
+        size_t lower_bound_index(const K* keys, size_t size, const K& key, const Compare& comp) {
+            if constexpr (is_linear_searchable_v<K, Compare>) {
+                if (size <= N)
+                    return simd::count_less(keys, size, key);
+                const K* first = keys;
+                for (; size > 1; size -= size / 2)
+                    first = first[size / 2 - 1] < key ? first + size / 2 : first;
+                return static_cast<size_t>(first - keys) + static_cast<size_t>(*first < key);
+            } else {
+                return static_cast<size_t>(std::lower_bound(keys, keys + size, key, comp) - keys);
+            }
+        }
+    }
+
+    //Sorted set of unique keys, which are stored in a small_vector. Lookups of arithmetic keys scan the small buffer
+    //with SIMD instructions, larger sets use a binary search. Inserting and erasing moves the following keys, so
+    //small_flat_set is meant for a few dozen elements (like std::flat_set).
+    template<typename K, size_t N = 8, typename Compare = std::less<K>, typename Alloc = std::allocator<K>>
+    class small_flat_set : private detail::compare_holder<Compare> {
+        using compare_holder = detail::compare_holder<Compare>;
+    public:
+        using container_type = small_vector<K, N, Alloc>;
+        using key_type = K;
+        using value_type = K;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using allocator_type = Alloc;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = const K&;
+        using const_reference = const K&;
+        //keys can't be modified in place, as that could break the order
+        using iterator = const K*;
+        using const_iterator = const K*;
+        using reverse_iterator = std::reverse_iterator<const_iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        small_flat_set() = default;
+        explicit small_flat_set(const Compare& comp, const Alloc& alloc = Alloc()) : compare_holder(comp), m_keys(alloc) {}
+        explicit small_flat_set(const Alloc& alloc) : m_keys(alloc) {}
+        template<class InputIt, typename = detail::enable_if_iterator_t<InputIt>>
+        small_flat_set(InputIt first, InputIt last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : compare_holder(comp), m_keys(alloc) {
+            insert(first, last);
+        }
+        small_flat_set(std::initializer_list<K> init, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : small_flat_set(init.begin(), init.end(), comp, alloc) {}
+        small_flat_set& operator=(std::initializer_list<K> init) {
+            clear();
+            insert(init.begin(), init.end());
+            return *this;
+        }
+
+        const_iterator begin() const noexcept { return m_keys.begin(); }
+        const_iterator cbegin() const noexcept { return m_keys.begin(); }
+        const_iterator end() const noexcept { return m_keys.end(); }
+        const_iterator cend() const noexcept { return m_keys.end(); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+        [[nodiscard]] bool empty() const noexcept { return m_keys.empty(); }
+        size_type size() const noexcept { return m_keys.size(); }
+        size_type max_size() const noexcept { return m_keys.max_size(); }
+        size_type capacity() const noexcept { return m_keys.capacity(); }
+        void reserve(size_type newCapacity) { m_keys.reserve(newCapacity); }
+        void shrink_to_fit() { m_keys.shrink_to_fit(); }
+        void clear() noexcept { m_keys.clear(); }
+        //the sorted keys
+        const container_type& keys() const noexcept { return m_keys; }
+        key_compare key_comp() const { return this->comp(); }
+        value_compare value_comp() const { return this->comp(); }
+        allocator_type get_allocator() const noexcept { return m_keys.get_allocator(); }
+
+        std::pair<iterator, bool> insert(const K& key) { return emplace(key); }
+        std::pair<iterator, bool> insert(K&& key) { return emplace(std::move(key)); }
+        template<class InputIt, typename = detail::enable_if_iterator_t<InputIt>>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first)
+                emplace(*first);
+        }
+        void insert(std::initializer_list<K> init) { insert(init.begin(), init.end()); }
+        template<class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            K key(std::forward<Args>(args)...);
+            //appending sorted keys doesn't need a search
+            if (m_keys.empty() || this->comp()(m_keys.back(), key)) {
+                m_keys.push_back(std::move(key));
+                return {std::prev(end()), true};
+            }
+            const size_type index = lower_bound_index(key);
+            if (index != size() && !this->comp()(key, m_keys[index]))
+                return {begin() + index, false};
+            return {m_keys.insert(m_keys.begin() + index, std::move(key)), true};
+        }
+
+        iterator erase(const_iterator pos) { return m_keys.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return m_keys.erase(first, last); }
+        size_type erase(const K& key) {
+            const const_iterator it = find(key);
+            if (it == end())
+                return 0;
+            m_keys.erase(it);
+            return 1;
+        }
+
+        const_iterator find(const K& key) const {
+            const size_type index = lower_bound_index(key);
+            return index != size() && !this->comp()(key, m_keys[index]) ? begin() + index : end();
+        }
+        bool contains(const K& key) const { return find(key) != end(); }
+        size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+        const_iterator lower_bound(const K& key) const { return begin() + lower_bound_index(key); }
+        const_iterator upper_bound(const K& key) const {
+            const const_iterator it = lower_bound(key);
+            return it != end() && !this->comp()(key, *it) ? std::next(it) : it;
+        }
+        std::pair<const_iterator, const_iterator> equal_range(const K& key) const { return {lower_bound(key), upper_bound(key)}; }
+
+        void swap(small_flat_set& other) noexcept(noexcept(std::declval<container_type&>().swap(std::declval<container_type&>()))) {
+            using std::swap;
+            swap(static_cast<compare_holder&>(*this), static_cast<compare_holder&>(other));
+            m_keys.swap(other.m_keys);
+        }
+        friend void swap(small_flat_set& a, small_flat_set& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+        friend bool operator==(const small_flat_set& lhs, const small_flat_set& rhs) { return lhs.m_keys == rhs.m_keys; }
+        friend bool operator!=(const small_flat_set& lhs, const small_flat_set& rhs) { return lhs.m_keys != rhs.m_keys; }
+
+    private:
+        size_type lower_bound_index(const K& key) const {
+            return detail::lower_bound_index<N>(m_keys.data(), m_keys.size(), key, this->comp());
+        }
+
+        container_type m_keys;
+    };
+}
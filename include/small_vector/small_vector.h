@@ -1,17 +1,149 @@
 // Licensed under the Unlicense <https://unlicense.org/>
 // SPDX-License-Identifier: Unlicense
 #pragma once
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <vector>
+#if __has_include(<memory_resource>)
+#  include <memory_resource>
+#endif
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+#if defined(SBO_SPILL_TELEMETRY)
+#  include <small_vector/spill_telemetry.h>
+#endif
+#if defined(SBO_SIZE_PROFILING)
+#  include <small_vector/size_profile.h>
+#endif
 
 namespace sbo{
 
-    template<typename T, size_t MaxSize = 8, typename NonReboundT = T>
-    struct small_buffer_vector_allocator{
+    //Result of allocate_at_least (P0401), the allocation can hold count elements, which might be more than requested.
+    //Allocators can provide an allocate_at_least member to report the slack of their size classes to small_vector.
+    template<typename Pointer>
+    struct allocation_result {
+        Pointer ptr;
+        size_t count;
+    };
+
+    namespace detail {
+        //holds the upstream allocator, stateless allocators don't take any space (empty base optimization)
+        template<typename Alloc, bool = std::is_empty_v<Alloc> && !std::is_final_v<Alloc>>
+        struct allocator_holder : private Alloc {
+            constexpr allocator_holder() noexcept(std::is_nothrow_default_constructible_v<Alloc>) = default;
+            constexpr explicit allocator_holder(const Alloc& alloc) noexcept : Alloc(alloc) {}
+            constexpr Alloc& alloc() noexcept { return *this; }
+            constexpr const Alloc& alloc() const noexcept { return *this; }
+        };
+        template<typename Alloc>
+        struct allocator_holder<Alloc, false> {
+            constexpr allocator_holder() noexcept(std::is_nothrow_default_constructible_v<Alloc>) = default;
+            constexpr explicit allocator_holder(const Alloc& alloc) noexcept : m_alloc(alloc) {}
+            constexpr Alloc& alloc() noexcept { return m_alloc; }
+            constexpr const Alloc& alloc() const noexcept { return m_alloc; }
+        private:
+            Alloc m_alloc{};
+        };
+
+        template<typename It>
+        using iterator_category_t = typename std::iterator_traits<It>::iterator_category;
+
+        template<typename It, typename = void>
+        struct is_iterator : std::false_type {};
+        template<typename It>
+        struct is_iterator<It, std::void_t<iterator_category_t<It>>> 
+            : std::is_convertible<iterator_category_t<It>, std::input_iterator_tag> {};
+
+        //used to disambiguate the iterator range overloads from the (count, value) overloads
+        template<typename It>
+        using enable_if_iterator_t = std::enable_if_t<is_iterator<It>::value>;
+
+        template<typename It>
+        constexpr bool is_forward_iterator_v = std::is_convertible_v<iterator_category_t<It>, std::forward_iterator_tag>;
+
+        //ranges with data() and size() of exactly T, which can be copied with memcpy for trivially copyable types
+        template<typename Range, typename T, typename = void>
+        struct is_contiguous_range : std::false_type {};
+        template<typename Range, typename T>
+        struct is_contiguous_range<Range, T, std::void_t<decltype(std::data(std::declval<Range&>())), decltype(std::size(std::declval<Range&>()))>> 
+            : std::is_same<std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<Range&>()))>>, T> {};
+
+        template<typename It, typename T>
+        constexpr bool is_memcpy_copyable_v = std::is_pointer_v<It> && std::is_trivially_copyable_v<T>
+            && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<It>>, T>;
+
+        template<typename Alloc, typename T, typename = void>
+        struct has_construct : std::false_type {};
+        template<typename Alloc, typename T>
+        struct has_construct<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().construct(std::declval<T*>(), std::declval<const T&>()))>> 
+            : std::true_type {};
+        template<typename Alloc, typename T, typename = void>
+        struct has_destroy : std::false_type {};
+        template<typename Alloc, typename T>
+        struct has_destroy<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().destroy(std::declval<T*>()))>> : std::true_type {};
+
+        template<typename Alloc, typename T, typename = void>
+        struct has_reallocate : std::false_type {};
+        template<typename Alloc, typename T>
+        struct has_reallocate<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().reallocate(std::declval<T*>(), size_t(), size_t()))>> 
+            : std::true_type {};
+
+        template<typename Alloc, typename = void>
+        struct has_allocate_at_least : std::false_type {};
+        template<typename Alloc>
+        struct has_allocate_at_least<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_at_least(size_t()))>> 
+            : std::true_type {};
+
+        //uses allocate_at_least if the allocator provides it, otherwise exactly n elements are allocated
+        template<typename Alloc>
+        constexpr auto allocate_at_least(Alloc& alloc, size_t n) {
+            using pointer = typename std::allocator_traits<Alloc>::pointer;
+            if constexpr (has_allocate_at_least<Alloc>::value) {
+                const auto result = alloc.allocate_at_least(n);
+                return allocation_result<pointer>{result.ptr, static_cast<size_t>(result.count)};
+            } else {
+                return allocation_result<pointer>{std::allocator_traits<Alloc>::allocate(alloc, n), n};
+            }
+        }
+
+        //Whether the allocator customizes the construction or destruction of the elements. destroy is only looked up
+        //without a construct member, as polymorphic_allocator::destroy is deprecated in C++20.
+        template<typename Alloc, typename T>
+        constexpr bool allocator_constructs_v = !std::is_same_v<Alloc, std::allocator<T>> 
+            && std::disjunction_v<has_construct<Alloc, T>, has_destroy<Alloc, T>>;
+
+        //empty base of small_vector, size_profile.h contains the one of the profiling mode
+        struct no_size_profile {
+            void note_size(size_t) noexcept {}
+            template<typename Vec, typename T, size_t N>
+            void record(size_t) noexcept {}
+        };
+#if defined(SBO_SIZE_PROFILING)
+        using size_profile_base = size_profile;
+#else
+        using size_profile_base = no_size_profile;
+#endif
+    }
+
+    //Alloc is the upstream allocator, which is used for all requests that don't fit into the small buffer
+    template<typename T, size_t MaxSize = 8, typename Alloc = std::allocator<T>, typename NonReboundT = T>
+    struct small_buffer_vector_allocator : private detail::allocator_holder<Alloc> {
+    private:
+        using upstream_holder = detail::allocator_holder<Alloc>;
+    public:
         alignas(alignof(T)) std::byte m_smallBuffer[MaxSize * sizeof(T)];
-        std::allocator<T> m_alloc{};
         bool m_smallBufferUsed = false;
         
         using value_type = T;
@@ -21,80 +153,1333 @@ namespace sbo{
         using is_always_equal = std::false_type;
 
         constexpr small_buffer_vector_allocator() noexcept = default;
-        template<class U>
-        constexpr small_buffer_vector_allocator(const small_buffer_vector_allocator<U, MaxSize, NonReboundT>&) noexcept {}
+        constexpr explicit small_buffer_vector_allocator(const Alloc& upstream) noexcept : upstream_holder(upstream) {}
+        template<class U, class UAlloc>
+        constexpr small_buffer_vector_allocator(const small_buffer_vector_allocator<U, MaxSize, UAlloc, NonReboundT>& other) noexcept 
+            : upstream_holder(Alloc(other.upstream())) {}
 
         template <class U>
         struct rebind{
-            typedef small_buffer_vector_allocator<U, MaxSize, NonReboundT> other;
+            typedef small_buffer_vector_allocator<U, MaxSize, typename std::allocator_traits<Alloc>::template rebind_alloc<U>, NonReboundT> other;
         };
         //don't copy the small buffer for the copy/move constructors, as the copying is done through the vector
-        constexpr small_buffer_vector_allocator(const small_buffer_vector_allocator& other) noexcept : m_smallBufferUsed(other.m_smallBufferUsed) {}
-        constexpr small_buffer_vector_allocator& operator=(const small_buffer_vector_allocator& other) noexcept {  m_smallBufferUsed = other.m_smallBufferUsed; return *this; }
-        constexpr small_buffer_vector_allocator(small_buffer_vector_allocator&&) noexcept {}
-        constexpr small_buffer_vector_allocator& operator=(const small_buffer_vector_allocator&&) noexcept { return *this; }
+        constexpr small_buffer_vector_allocator(const small_buffer_vector_allocator& other) noexcept 
+            : upstream_holder(other.upstream()), m_smallBufferUsed(other.m_smallBufferUsed) {}
+        constexpr small_buffer_vector_allocator& operator=(const small_buffer_vector_allocator& other) noexcept {  
+            this->alloc() = other.upstream(); 
+            m_smallBufferUsed = other.m_smallBufferUsed; 
+            return *this; 
+        }
+        constexpr small_buffer_vector_allocator(small_buffer_vector_allocator&& other) noexcept : upstream_holder(other.upstream()) {}
+        constexpr small_buffer_vector_allocator& operator=(const small_buffer_vector_allocator&& other) noexcept { 
+            this->alloc() = other.upstream(); 
+            return *this; 
+        }
+
+        constexpr const Alloc& upstream() const noexcept { return this->alloc(); }
 
-        [[nodiscard]] constexpr T* allocate(const size_t n) {
+        [[nodiscard]] constexpr T* allocate(const size_t n) { return allocate_at_least(n).ptr; }
+        //the small buffer always provides MaxSize elements, heap allocations report the slack of the upstream allocator
+        [[nodiscard]] constexpr allocation_result<T*> allocate_at_least(const size_t n) {
             //when the allocator was rebound we don't want to use the small buffer
             if constexpr (std::is_same_v<T, NonReboundT>) {
                 if (n <= MaxSize) {
                     m_smallBufferUsed = true;
                     //as long as we use less memory than the small buffer, we return a pointer to it
-                    return reinterpret_cast<T*>(&m_smallBuffer);
+                    return {reinterpret_cast<T*>(&m_smallBuffer), MaxSize};
                 }
             }
             m_smallBufferUsed = false;
-            //otherwise use the default allocator
-            return m_alloc.allocate(n);
+            //otherwise use the upstream allocator
+            return detail::allocate_at_least(this->alloc(), n);
         }
         constexpr void deallocate(void* p, const size_t n) {
           // we don't deallocate anything if the memory was allocated in small buffer
           if (&m_smallBuffer != p) 
-              m_alloc.deallocate(static_cast<T*>(p), n);
+              std::allocator_traits<Alloc>::deallocate(this->alloc(), static_cast<T*>(p), n);
           m_smallBufferUsed = false;
         }
         //according to the C++ standard when propagate_on_container_move_assignment is set to false, the comparision operators are used 
         //to check if two allocators are equal. When they are not, an element wise move is done instead of just taking over the memory. 
         //For our implementation this means the comparision has to return false, when the small buffer is active
         friend constexpr bool operator==(const small_buffer_vector_allocator& lhs, const small_buffer_vector_allocator& rhs) {
-            return !lhs.m_smallBufferUsed && !rhs.m_smallBufferUsed;
+            return !lhs.m_smallBufferUsed && !rhs.m_smallBufferUsed && lhs.upstream() == rhs.upstream();
         }
         friend constexpr bool operator!=(const small_buffer_vector_allocator& lhs, const small_buffer_vector_allocator& rhs) {
             return !(lhs == rhs);
         }
     };
 
-    template<typename T, size_t N = 8>
-    class small_vector : public std::vector<T, small_buffer_vector_allocator<T, N>>{
+    //Allocator based on malloc/free. Its reallocate member is used by small_vector to grow the heap memory of
+    //trivially relocatable types with realloc, which can extend the block in place (and uses mremap for large blocks
+    //on glibc) instead of copying all elements. On glibc allocate_at_least and reallocate report the usable size 
+    //of the block (malloc rounds the requests up to its size classes), so the slack is used as capacity.
+    template<typename T>
+    struct malloc_allocator {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "malloc doesn't support over aligned types");
+        using value_type = T;
+
+        constexpr malloc_allocator() noexcept = default;
+        template<class U>
+        constexpr malloc_allocator(const malloc_allocator<U>&) noexcept {}
+
+        [[nodiscard]] T* allocate(const size_t n) {
+            if (void* p = std::malloc(n * sizeof(T)))
+                return static_cast<T*>(p);
+            throw std::bad_alloc();
+        }
+        [[nodiscard]] allocation_result<T*> allocate_at_least(const size_t n) {
+            T* p = allocate(n);
+            return {p, usable_count(p, n)};
+        }
+        void deallocate(T* p, const size_t /*n*/) noexcept { std::free(p); }
+        //like std::allocator, larger requests can't succeed (and GCC warns about them with -Walloc-size-larger-than)
+        size_t max_size() const noexcept { return PTRDIFF_MAX / sizeof(T); }
+        //only valid for trivially relocatable types, the bytes are moved to the new block
+        [[nodiscard]] allocation_result<T*> reallocate(T* p, const size_t /*oldN*/, const size_t newN) {
+            if (void* newP = std::realloc(p, newN * sizeof(T)))
+                return {static_cast<T*>(newP), usable_count(static_cast<T*>(newP), newN)};
+            throw std::bad_alloc();
+        }
+        friend constexpr bool operator==(const malloc_allocator&, const malloc_allocator&) noexcept { return true; }
+        friend constexpr bool operator!=(const malloc_allocator&, const malloc_allocator&) noexcept { return false; }
+    private:
+        static size_t usable_count(T* p, size_t n) noexcept {
+#if defined(__GLIBC__)
+            return std::max(n, malloc_usable_size(p) / sizeof(T));
+#else
+            static_cast<void>(p);
+            return n;
+#endif
+        }
+    };
+
+    //Customization point for types that can be moved to a new address with memcpy, without calling the move
+    //constructor and the destructor of the moved from object (e.g. types that only hold pointers to the heap).
+    //small_vector uses it to move the small buffer and to reallocate in one go.
+    template<typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+    template<typename T>
+    struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+    template<typename T>
+    struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+    template<typename T>
+    constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    //Shrink policies decide if a small_vector moves its elements from the heap back into the small buffer, after
+    //elements were removed (erase, pop_back, resize, clear). shrink_to_fit() always moves them back if they fit.
+    struct never_shrink {
+        static constexpr bool should_shrink(size_t /*size*/, size_t /*smallBufferSize*/) noexcept { return false; }
+    };
+    //shrinks once the size drops to Percent of the small buffer size, use less than 100 to avoid moving 
+    //back and forth when the size oscillates around N
+    template<size_t Percent = 50>
+    struct shrink_below_percent {
+        static constexpr bool should_shrink(size_t size, size_t smallBufferSize) noexcept { 
+            return size * 100 <= smallBufferSize * Percent; 
+        }
+    };
+
+    namespace detail {
+        constexpr size_t saturating_mul(size_t a, size_t b) noexcept {
+            return b != 0 && a > std::numeric_limits<size_t>::max() / b ? std::numeric_limits<size_t>::max() : a * b;
+        }
+        constexpr size_t round_up(size_t value, size_t multiple) noexcept {
+            return value > std::numeric_limits<size_t>::max() - multiple ? value : (value + multiple - 1) / multiple * multiple;
+        }
+    }
+
+    //Growth policies compute the capacity of the next heap allocation, once the current capacity is exhausted.
+    //next_capacity has to return at least minCapacity, small_vector clamps the result to max_size().
+    template<size_t Numerator, size_t Denominator = 1>
+    struct growth_factor {
+        static_assert(Numerator > Denominator, "the capacity has to grow");
+        static constexpr size_t next_capacity(size_t capacity, size_t minCapacity, size_t /*elementSize*/) noexcept {
+            return std::max(detail::saturating_mul(capacity / Denominator, Numerator) + capacity % Denominator * Numerator / Denominator, 
+                            minCapacity);
+        }
+    };
+    using grow_double = growth_factor<2>;
+    using grow_one_and_a_half = growth_factor<3, 2>;
+
+    //grows linearly, which saves memory for sizes slightly above N, but appending isn't amortized O(1) any more
+    template<size_t Increment>
+    struct grow_by {
+        static_assert(Increment > 0, "the capacity has to grow");
+        static constexpr size_t next_capacity(size_t capacity, size_t minCapacity, size_t /*elementSize*/) noexcept {
+            return std::max(capacity > std::numeric_limits<size_t>::max() - Increment ? capacity : capacity + Increment, minCapacity);
+        }
+    };
+
+    //doubles and rounds the allocation up to the size classes of typical malloc implementations (16 byte steps up
+    //to 128 bytes, then four classes per power of two), so no memory is wasted as malloc slack
+    struct grow_to_size_class {
+        static constexpr size_t round_to_size_class(size_t bytes) noexcept {
+            if (bytes <= 128)
+                return detail::round_up(bytes, 16);
+            size_t powerOfTwo = 128;
+            while (powerOfTwo < (bytes - 1) / 2 + 1)
+                powerOfTwo *= 2;
+            return detail::round_up(bytes, powerOfTwo / 4);
+        }
+        static constexpr size_t next_capacity(size_t capacity, size_t minCapacity, size_t elementSize) noexcept {
+            const size_t bytes = detail::saturating_mul(std::max(detail::saturating_mul(capacity, 2), minCapacity), elementSize);
+            return std::max(round_to_size_class(bytes) / elementSize, minCapacity);
+        }
+    };
+
+    //doubles and rounds the allocation up to a multiple of the page size, for large buffers
+    template<size_t PageSize = 4096>
+    struct grow_to_page_multiple {
+        static constexpr size_t next_capacity(size_t capacity, size_t minCapacity, size_t elementSize) noexcept {
+            const size_t bytes = detail::saturating_mul(std::max(detail::saturating_mul(capacity, 2), minCapacity), elementSize);
+            return std::max(detail::round_up(bytes, PageSize) / elementSize, minCapacity);
+        }
+    };
+
+    //tag for the constructor which default initializes the elements, trivial types are left uninitialized
+    struct default_init_t {
+        explicit default_init_t() = default;
+    };
+    inline constexpr default_init_t default_init{};
+
+//Branch hint and attribute of the rarely taken paths, which are kept out of the inlined fast paths.
+//The tree is C++17, so __builtin_expect is used instead of [[likely]].
+#if defined(__GNUC__) || defined(__clang__)
+#  define SBO_LIKELY(condition) __builtin_expect(static_cast<bool>(condition), 1)
+#  define SBO_COLD [[gnu::noinline, gnu::cold]]
+#elif defined(_MSC_VER)
+#  define SBO_LIKELY(condition) (condition)
+#  define SBO_COLD __declspec(noinline)
+#else
+#  define SBO_LIKELY(condition) (condition)
+#  define SBO_COLD
+#endif
+
+//With SBO_SIZE_PROFILING every constructor of small_vector takes the location of its caller as an additional
+//defaulted argument (see size_profile.h)
+#if defined(SBO_SIZE_PROFILING)
+#  define SBO_SITE_DECL , detail::source_site site
+#  define SBO_SITE_ONLY_PARAM detail::source_site site = detail::source_site::current()
+#  define SBO_SITE_PARAM , SBO_SITE_ONLY_PARAM
+#  define SBO_SITE_ARG , site
+#  define SBO_SITE_INIT detail::size_profile_base(site),
+#else
+#  define SBO_SITE_DECL
+#  define SBO_SITE_ONLY_PARAM
+#  define SBO_SITE_PARAM
+#  define SBO_SITE_ARG
+#  define SBO_SITE_INIT
+#endif
+
+    namespace detail {
+        //the small buffer of small_vector directly follows the members of small_vector_impl (in its tail padding)
+        template<typename Impl, typename T>
+        struct inline_buffer_layout : Impl {
+            alignas(alignof(T)) std::byte m_firstElement[sizeof(T)];
+        };
+    }
+
+    //small_vector_impl is the part of small_vector which doesn't depend on N, similar to llvm::SmallVectorImpl.
+    //Functions can take a small_vector_impl<T>& to accept small_vectors with any N, and all small_vectors of the
+    //same element type share the code of their members. It can't be constructed on its own.
+    //The small buffer follows the members of small_vector_impl, so it's found without storing its address. While
+    //the heap memory is used, the unused small buffer stores N (see inline_capacity()).
+    template<typename T, typename Alloc = std::allocator<T>, typename SizeType = std::size_t, 
+             typename ShrinkPolicy = never_shrink, typename GrowthPolicy = grow_double>
+    class small_vector_impl : protected detail::allocator_holder<Alloc>, private detail::size_profile_base {
+        using alloc_traits = std::allocator_traits<Alloc>;
+        static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "Alloc::value_type has to be T");
+        static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+        static_assert(std::is_unsigned_v<SizeType>, "SizeType has to be an unsigned integer");
     public:
-        using vectorT = std::vector<T, small_buffer_vector_allocator<T, N>>;
-        //default initialize with the small buffer size
-        constexpr small_vector() noexcept { vectorT::reserve(N); }
-        small_vector(const small_vector& other) {
-          vectorT::reserve(N);
-          (*this = other);
-        }
-        small_vector& operator=(const small_vector& ) = default;
-        small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
-            if (other.size() <= N)
-                vectorT::reserve(N);
-            vectorT::operator=(std::move(other));
-        }
-        small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
-            if(other.size() <= N)
-                vectorT::reserve(N);
-            vectorT::operator=(std::move(other));
+        using value_type = T;
+        using allocator_type = Alloc;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        small_vector_impl(const small_vector_impl&) = delete;
+
+        //copies or moves the elements, the sizes of the small buffers may differ
+        small_vector_impl& operator=(const small_vector_impl& other) {
+            if (this == &other)
+                return *this;
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                //our heap memory can't be deallocated by the allocator of other
+                if (this->alloc() != other.alloc()) {
+                    clear();
+                    release_heap();
+                }
+                this->alloc() = other.alloc();
+            }
+            assign_n(other.begin(), other.size());
             return *this;
         }
-        //use the default constructor first to reserve then construct the values
-        explicit small_vector(size_t count) : small_vector() { vectorT::resize(count); }
-        small_vector(size_t count, const T& value) : small_vector() { vectorT::assign(count, value); }
-        template<class InputIt>
-        small_vector(InputIt first, InputIt last) : small_vector()   { vectorT::insert(vectorT::begin(), first, last); }
-        small_vector(std::initializer_list<T> init) : small_vector() { vectorT::insert(vectorT::begin(), init); }
-        friend void swap(small_vector& a, small_vector& b) noexcept {
-            using std::swap;
-            swap(static_cast<vectorT&>(a), static_cast<vectorT&>(b));
+        //Not noexcept: other may have a larger small buffer whose elements don't fit into our capacity, which allocates.
+        //small_vector's move assignment from the same type is noexcept, because both small buffers have the same size.
+        //The heap memory of other is only taken over if its elements don't fit into our small buffer.
+        small_vector_impl& operator=(small_vector_impl&& other) {
+            move_assign(other, true);
+            return *this;
+        }
+        small_vector_impl& operator=(std::initializer_list<T> init) {
+            assign(init.begin(), init.end());
+            return *this;
+        }
+
+        void assign(size_type count, const T& value) {
+            if (count > m_capacity) {
+                //construct the new elements before destroying the old ones, value might be one of them
+                note_growth(checked_capacity(count));
+                const auto [newBegin, newCapacity] = allocate(count);
+                try {
+                    uninitialized_fill_n(newBegin, count, value);
+                } catch (...) {
+                    deallocate(newBegin, newCapacity);
+                    throw;
+                }
+                destroy(begin(), end());
+                replace_storage(newBegin, newCapacity);
+                set_size(count);
+                return;
+            }
+            std::fill_n(begin(), std::min(count, size()), value);
+            if (count > m_size)
+                uninitialized_fill_n(end(), count - m_size, value);
+            else
+                destroy(begin() + count, end());
+            set_size(count);
+        }
+        template<class InputIt, typename = detail::enable_if_iterator_t<InputIt>>
+        void assign(InputIt first, InputIt last) {
+            if constexpr (detail::is_forward_iterator_v<InputIt>) {
+                assign_n(first, static_cast<size_type>(std::distance(first, last)));
+            } else {
+                clear();
+                for (; first != last; ++first)
+                    emplace_back(*first);
+            }
+        }
+        void assign(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+        //Replaces the elements by the ones of vec and leaves vec empty. std::vector can't hand over its heap memory,
+        //so the elements are moved (with at most one allocation, trivially copyable types with memcpy).
+        template<typename VectorAlloc>
+        void adopt(std::vector<T, VectorAlloc>&& vec) {
+            if constexpr (std::is_trivially_copyable_v<T>)
+                assign_n(vec.data(), vec.size());
+            else
+                assign_n(std::make_move_iterator(vec.data()), vec.size());
+            vec.clear();
+        }
+        //moves the elements into a std::vector and releases the heap memory, this vector is empty afterwards
+        template<typename VectorAlloc = std::allocator<T>>
+        std::vector<T, VectorAlloc> release_to_vector(const VectorAlloc& vectorAlloc = VectorAlloc()) {
+            std::vector<T, VectorAlloc> vec(vectorAlloc);
+            vec.reserve(m_size);
+            vec.insert(vec.end(), std::make_move_iterator(begin()), std::make_move_iterator(end()));
+            clear();
+            release_heap();
+            return vec;
+        }
+        allocator_type get_allocator() const noexcept { return this->alloc(); }
+
+        reference at(size_type pos) {
+            if (pos >= m_size)
+                throw std::out_of_range("sbo::small_vector::at");
+            return m_begin[pos];
+        }
+        const_reference at(size_type pos) const {
+            if (pos >= m_size)
+                throw std::out_of_range("sbo::small_vector::at");
+            return m_begin[pos];
+        }
+        reference operator[](size_type pos) noexcept { return m_begin[pos]; }
+        const_reference operator[](size_type pos) const noexcept { return m_begin[pos]; }
+        reference front() noexcept { return m_begin[0]; }
+        const_reference front() const noexcept { return m_begin[0]; }
+        reference back() noexcept { return m_begin[m_size - 1]; }
+        const_reference back() const noexcept { return m_begin[m_size - 1]; }
+        T* data() noexcept { return m_begin; }
+        const T* data() const noexcept { return m_begin; }
+
+        iterator begin() noexcept { return m_begin; }
+        const_iterator begin() const noexcept { return m_begin; }
+        const_iterator cbegin() const noexcept { return m_begin; }
+        iterator end() noexcept { return m_begin + m_size; }
+        const_iterator end() const noexcept { return m_begin + m_size; }
+        const_iterator cend() const noexcept { return m_begin + m_size; }
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+        [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+        size_type size() const noexcept { return m_size; }
+        size_type max_size() const noexcept {
+            return std::min<size_type>(alloc_traits::max_size(this->alloc()), std::numeric_limits<SizeType>::max());
+        }
+        size_type capacity() const noexcept { return m_capacity; }
+        //true while the elements are stored in the small buffer
+        bool is_small() const noexcept { return m_begin == inline_buffer(); }
+        //the number of elements which fit into the small buffer (N of the small_vector)
+//GCC doesn't see that the small buffer stores N whenever the heap memory is used
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+        size_type inline_capacity() const noexcept {
+            if (is_small())
+                return m_capacity;
+            SizeType inlineCapacity;
+            std::memcpy(&inlineCapacity, inline_buffer(), sizeof(SizeType));
+            return inlineCapacity;
+        }
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+        void reserve(size_type newCapacity) {
+            if (newCapacity > m_capacity) {
+                note_growth(checked_capacity(newCapacity));
+                reallocate(newCapacity);
+            }
+        }
+        //moves the elements back into the small buffer if they fit, otherwise into a heap block of the exact size
+        void shrink_to_fit() {
+            if (is_small())
+                return;
+            if (m_size <= inline_capacity())
+                move_to_small_buffer();
+            else if (m_size != m_capacity)
+                reallocate(m_size);
+        }
+
+        void clear() noexcept {
+            truncate(0);
+        }
+        iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+        iterator insert(const_iterator pos, T&& value) {
+            const size_type index = index_of(pos);
+            if (m_size == m_capacity) {
+                realloc_insert(index, 1, [&](T* gap) { construct(gap, std::move(value)); });
+            } else if (index == m_size) {
+                construct(end(), std::move(value));
+                ++m_size;
+            } else if constexpr (is_trivially_relocatable_v<T>) {
+                shift_insert(index, 1, [&](T* gap) { construct(gap, std::move(value)); });
+            } else {
+                open_gap(index);
+                m_begin[index] = std::move(value);
+            }
+            return begin() + index;
+        }
+        iterator insert(const_iterator pos, size_type count, const T& value) {
+            const size_type index = index_of(pos);
+            if (count == 0)
+                return begin() + index;
+            if (m_size + count > m_capacity) {
+                realloc_insert(index, count, [&](T* gap) { uninitialized_fill_n(gap, count, value); });
+                return begin() + index;
+            }
+            if constexpr (is_trivially_relocatable_v<T>) {
+                //value might reference an element of this vector at or behind pos, which is moved by count positions
+                const bool shifted = !std::less<const T*>()(&value, begin() + index) && std::less<const T*>()(&value, end());
+                const size_type valueIndex = shifted ? static_cast<size_type>(&value - begin()) + count : 0;
+                shift_insert(index, count, [&](T* gap) {
+                    uninitialized_fill_n(gap, count, shifted ? m_begin[valueIndex] : value);
+                });
+                return begin() + index;
+            }
+            //value might reference an element of this vector, which gets overwritten while shifting
+            const T copy(value);
+            T* first = begin() + index;
+            T* oldEnd = end();
+            const size_type elemsAfter = m_size - index;
+            if (elemsAfter > count) {
+                uninitialized_move(oldEnd - count, oldEnd, oldEnd);
+                set_size(m_size + count);
+                std::move_backward(first, oldEnd - count, oldEnd);
+                std::fill_n(first, count, copy);
+            } else {
+                uninitialized_fill_n(oldEnd, count - elemsAfter, copy);
+                set_size(m_size + count - elemsAfter);
+                uninitialized_move(first, oldEnd, end());
+                set_size(m_size + elemsAfter);
+                std::fill(first, oldEnd, copy);
+            }
+            return first;
+        }
+        template<class InputIt, typename = detail::enable_if_iterator_t<InputIt>>
+        iterator insert(const_iterator pos, InputIt first, InputIt last) {
+            const size_type index = index_of(pos);
+            if constexpr (detail::is_forward_iterator_v<InputIt>) {
+                const auto count = static_cast<size_type>(std::distance(first, last));
+                if (m_size + count > m_capacity)
+                    realloc_insert(index, count, [&](T* gap) { uninitialized_copy_n(first, count, gap); });
+                else if (count != 0)
+                    insert_in_place(index, count, first, last);
+            } else {
+                //we don't know the number of elements up front, so append them and rotate them into place
+                const size_type oldSize = m_size;
+                for (; first != last; ++first)
+                    emplace_back(*first);
+                std::rotate(begin() + index, begin() + oldSize, end());
+            }
+            return begin() + index;
+        }
+        iterator insert(const_iterator pos, std::initializer_list<T> init) { return insert(pos, init.begin(), init.end()); }
+        template<class Range>
+        iterator insert_range(const_iterator pos, Range&& range) {
+            const size_type index = index_of(pos);
+            if (index == m_size)
+                append_range(range);
+            else
+                insert(pos, std::begin(range), std::end(range));
+            return begin() + index;
+        }
+        //Appends the elements of range and grows at most once. Contiguous ranges of trivially copyable elements 
+        //(e.g. std::vector, std::array or C arrays) are copied with memcpy.
+        template<class Range>
+        void append_range(Range&& range) {
+            if constexpr (detail::is_contiguous_range<Range, T>::value)
+                append(std::data(range), static_cast<size_type>(std::size(range)));
+            else
+                insert(end(), std::begin(range), std::end(range));
+        }
+        void append(const T* data, size_type count) { append_n(data, count); }
+        template<class... Args>
+        iterator emplace(const_iterator pos, Args&&... args) {
+            const size_type index = index_of(pos);
+            if (m_size == m_capacity) {
+                realloc_insert(index, 1, [&](T* gap) { construct(gap, std::forward<Args>(args)...); });
+            } else if (index == m_size) {
+                construct(end(), std::forward<Args>(args)...);
+                ++m_size;
+            } else {
+                //construct the new element first, as the arguments might reference an element of this vector
+                T tmp(std::forward<Args>(args)...);
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    shift_insert(index, 1, [&](T* gap) { construct(gap, std::move(tmp)); });
+                } else {
+                    open_gap(index);
+                    m_begin[index] = std::move(tmp);
+                }
+            }
+            return begin() + index;
+        }
+        iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+        iterator erase(const_iterator first, const_iterator last) {
+            const size_type index = index_of(first);
+            if (first == last)
+                return begin() + index;
+            if constexpr (is_trivially_relocatable_v<T>) {
+                //the erased elements are destroyed and the following ones are relocated with a single memmove
+                T* gap = begin() + index;
+                T* gapEnd = begin() + index_of(last);
+                destroy(gap, gapEnd);
+                std::memmove(static_cast<void*>(gap), static_cast<const void*>(gapEnd), static_cast<size_type>(end() - gapEnd) * sizeof(T));
+                set_size(m_size - static_cast<size_type>(gapEnd - gap));
+                shrink_by_policy();
+            } else {
+                T* newEnd = std::move(begin() + index_of(last), end(), begin() + index);
+                truncate(static_cast<size_type>(newEnd - begin()));
+            }
+            return begin() + index;
+        }
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+        //the fast path (compare, construct, increment) is inlined, growing is done out of line
+        template<class... Args>
+        reference emplace_back(Args&&... args) {
+            if (SBO_LIKELY(m_size != m_capacity)) {
+                T* element = m_begin + m_size;
+                construct(element, std::forward<Args>(args)...);
+                ++m_size;
+                return *element;
+            }
+            return grow_emplace_back(std::forward<Args>(args)...);
+        }
+        void pop_back() noexcept {
+            truncate(size() - 1);
+        }
+        void resize(size_type count) {
+            resize_with(count, [this](T* dest, size_type n) { uninitialized_value_construct_n(dest, n); });
+        }
+        //like resize, but the new elements are default initialized, which leaves trivial types uninitialized.
+        //Useful for buffers which are overwritten right away (e.g. by a decoder or a read from a socket).
+        void resize_for_overwrite(size_type count) {
+            resize_with(count, [this](T* dest, size_type n) { uninitialized_default_construct_n(dest, n); });
+        }
+        void resize(size_type count, const T& value) {
+            if (count <= m_size) {
+                truncate(count);
+            } else if (count > m_capacity) {
+                realloc_insert(m_size, count - m_size, [&](T* gap) { uninitialized_fill_n(gap, count - m_size, value); });
+            } else {
+                uninitialized_fill_n(end(), count - m_size, value);
+                set_size(count);
+            }
+        }
+
+        friend bool operator==(const small_vector_impl& lhs, const small_vector_impl& rhs) {
+            return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+        friend bool operator!=(const small_vector_impl& lhs, const small_vector_impl& rhs) { return !(lhs == rhs); }
+        friend bool operator<(const small_vector_impl& lhs, const small_vector_impl& rhs) {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+        friend bool operator>(const small_vector_impl& lhs, const small_vector_impl& rhs) { return rhs < lhs; }
+        friend bool operator<=(const small_vector_impl& lhs, const small_vector_impl& rhs) { return !(rhs < lhs); }
+        friend bool operator>=(const small_vector_impl& lhs, const small_vector_impl& rhs) { return !(lhs < rhs); }
+
+    protected:
+        explicit small_vector_impl(size_type inlineCapacity SBO_SITE_DECL) noexcept(std::is_nothrow_default_constructible_v<Alloc>)
+            : SBO_SITE_INIT m_begin(inline_buffer()), m_capacity(static_cast<SizeType>(inlineCapacity)) {}
+        small_vector_impl(size_type inlineCapacity, const Alloc& alloc SBO_SITE_DECL) noexcept 
+            : detail::allocator_holder<Alloc>(alloc), SBO_SITE_INIT m_begin(inline_buffer()), 
+              m_capacity(static_cast<SizeType>(inlineCapacity)) {}
+        ~small_vector_impl() {
+            destroy(begin(), end());
+            if (!is_small())
+                deallocate(m_begin, m_capacity);
+        }
+
+//the members of small_vector_impl are not standard layout, but the offset is still well defined without virtual bases
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+        static constexpr size_t inline_buffer_offset() noexcept {
+            using layout = detail::inline_buffer_layout<small_vector_impl, T>;
+            return offsetof(layout, m_firstElement);
+        }
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+        T* inline_buffer() noexcept { return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(this) + inline_buffer_offset()); }
+        const T* inline_buffer() const noexcept { 
+            return reinterpret_cast<const T*>(reinterpret_cast<const std::byte*>(this) + inline_buffer_offset()); 
         }
+        //called when the small buffer is left for heap memory, the elements have to be relocated or destroyed already
+        void store_inline_capacity(size_type inlineCapacity) noexcept {
+            const auto value = static_cast<SizeType>(inlineCapacity);
+            std::memcpy(static_cast<void*>(inline_buffer()), &value, sizeof(SizeType));
+        }
+        size_type index_of(const_iterator pos) const noexcept { return static_cast<size_type>(pos - begin()); }
+        //sizes never exceed max_size(), so they always fit into SizeType
+        void set_size(size_type size) noexcept { 
+            profile().note_size(m_size);
+            m_size = static_cast<SizeType>(size); 
+        }
+        //the peak size is noted before the size decreases (no op without SBO_SIZE_PROFILING)
+        detail::size_profile_base& profile() noexcept { return *this; }
+        //Counts the spills from the small buffer and the growths of the heap memory per <T, N> when SBO_SPILL_TELEMETRY
+        //is defined. requiredCapacity is the capacity the operation needs, before the growth policy is applied.
+        void note_growth(size_type requiredCapacity) {
+#if defined(SBO_SPILL_TELEMETRY)
+            detail::spill_counters_for<T>(inline_capacity()).record(requiredCapacity, is_small());
+#else
+            static_cast<void>(requiredCapacity);
+#endif
+        }
+
+        //the allocator might provide more than n elements (allocate_at_least), the slack is used as capacity
+        allocation_result<T*> allocate(size_type n) {
+            const auto result = detail::allocate_at_least(this->alloc(), n);
+            return {result.ptr, std::min(result.count, max_size())};
+        }
+        void deallocate(T* p, size_type n) noexcept { alloc_traits::deallocate(this->alloc(), p, n); }
+
+        //Elements are constructed and destroyed through the allocator, so that e.g. polymorphic_allocator or
+        //scoped_allocator_adaptor can pass themselves on to nested containers. Allocators without construct and
+        //destroy members use the std algorithms directly, which are optimized for trivial types.
+        template<class... Args>
+        void construct(T* p, Args&&... args) { alloc_traits::construct(this->alloc(), p, std::forward<Args>(args)...); }
+        void destroy(T* first, T* last) noexcept {
+            if constexpr (detail::allocator_constructs_v<Alloc, T>) {
+                for (; first != last; ++first)
+                    alloc_traits::destroy(this->alloc(), first);
+            } else {
+                std::destroy(first, last);
+            }
+        }
+        template<typename InputIt>
+        T* uninitialized_copy(InputIt first, InputIt last, T* dest) {
+            if constexpr (detail::allocator_constructs_v<Alloc, T>) {
+                T* current = dest;
+                try {
+                    for (; first != last; ++first, ++current)
+                        construct(current, *first);
+                } catch (...) {
+                    destroy(dest, current);
+                    throw;
+                }
+                return current;
+            } else {
+                return std::uninitialized_copy(first, last, dest);
+            }
+        }
+        template<typename ForwardIt>
+        T* uninitialized_copy_n(ForwardIt first, size_type count, T* dest) {
+            if constexpr (detail::is_memcpy_copyable_v<ForwardIt, T> && !detail::allocator_constructs_v<Alloc, T>) {
+                if (count != 0)
+                    memcpy_elements(dest, first, count);
+                return dest + count;
+            } else if constexpr (detail::allocator_constructs_v<Alloc, T>) {
+                return uninitialized_copy(first, std::next(first, static_cast<difference_type>(count)), dest);
+            } else {
+                return std::uninitialized_copy_n(first, count, dest);
+            }
+        }
+        T* uninitialized_move(T* first, T* last, T* dest) {
+            return uninitialized_copy(std::make_move_iterator(first), std::make_move_iterator(last), dest);
+        }
+        template<class... Args>
+        T* uninitialized_construct_n(T* dest, size_type count, const Args&... args) {
+            T* current = dest;
+            try {
+                for (; count > 0; --count, ++current)
+                    construct(current, args...);
+            } catch (...) {
+                destroy(dest, current);
+                throw;
+            }
+            return current;
+        }
+        T* uninitialized_fill_n(T* dest, size_type count, const T& value) {
+            if constexpr (detail::allocator_constructs_v<Alloc, T>)
+                return uninitialized_construct_n(dest, count, value);
+            else
+                return std::uninitialized_fill_n(dest, count, value);
+        }
+        T* uninitialized_value_construct_n(T* dest, size_type count) {
+            if constexpr (detail::allocator_constructs_v<Alloc, T>)
+                return uninitialized_construct_n(dest, count);
+            else
+                return std::uninitialized_value_construct_n(dest, count);
+        }
+        T* uninitialized_default_construct_n(T* dest, size_type count) {
+            if constexpr (detail::allocator_constructs_v<Alloc, T>)
+                return uninitialized_construct_n(dest, count);
+            else
+                return std::uninitialized_default_construct_n(dest, count);
+        }
+        //relocating uses the copy constructor when the move constructor could throw (like std::vector)
+        T* uninitialized_move_if_noexcept(T* first, T* last, T* dest) {
+            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                return uninitialized_move(first, last, dest);
+            else
+                return uninitialized_copy(first, last, dest);
+        }
+
+        size_type checked_capacity(size_type minCapacity) const {
+            if (minCapacity > max_size())
+                throw std::length_error("sbo::small_vector");
+            return minCapacity;
+        }
+        size_type next_capacity(size_type minCapacity) const {
+            checked_capacity(minCapacity);
+            const size_type grown = GrowthPolicy::next_capacity(capacity(), minCapacity, sizeof(T));
+            return std::clamp<size_type>(grown, minCapacity, max_size());
+        }
+        static void memcpy_elements(T* dest, const T* src, size_type count) noexcept {
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+        }
+        //releases the heap memory and takes over the new heap storage, the elements have to be destroyed or relocated already
+        void replace_storage(T* newBegin, size_type newCapacity) noexcept {
+            if (is_small())
+                store_inline_capacity(m_capacity);
+            else
+                deallocate(m_begin, m_capacity);
+            m_begin = newBegin;
+            m_capacity = static_cast<SizeType>(newCapacity);
+        }
+        void reallocate(size_type newCapacity) {
+            if (can_realloc_heap()) {
+                realloc_heap(newCapacity);
+                return;
+            }
+            const auto [newBegin, allocatedCapacity] = allocate(newCapacity);
+            try {
+                relocate_to(newBegin, m_size, 0);
+            } catch (...) {
+                deallocate(newBegin, allocatedCapacity);
+                throw;
+            }
+            replace_storage(newBegin, allocatedCapacity);
+        }
+        //Allocators with a reallocate member (e.g. malloc_allocator) can grow a heap block in place, which is used
+        //for trivially relocatable types. The first spill from the small buffer is always a copy.
+        static constexpr bool can_reallocate = is_trivially_relocatable_v<T> && detail::has_reallocate<Alloc, T>::value;
+        bool can_realloc_heap() const noexcept {
+            if constexpr (can_reallocate)
+                return !is_small();
+            else
+                return false;
+        }
+        void realloc_heap(size_type newCapacity) {
+            if constexpr (can_reallocate) {
+                const auto result = this->alloc().reallocate(m_begin, m_capacity, newCapacity);
+                m_begin = result.ptr;
+                m_capacity = static_cast<SizeType>(std::min(static_cast<size_type>(result.count), max_size()));
+            }
+        }
+        //grows or shrinks to count elements, constructN constructs the new elements at the end
+        template<typename ConstructN>
+        void resize_with(size_type count, ConstructN&& constructN) {
+            if (count <= m_size) {
+                truncate(count);
+            } else if (count > m_capacity && !can_realloc_heap()) {
+                realloc_insert(m_size, count - m_size, [&](T* gap) { constructN(gap, count - m_size); });
+            } else {
+                if (count > m_capacity) {
+                    note_growth(count);
+                    realloc_heap(next_capacity(count));
+                }
+                constructN(end(), count - m_size);
+                set_size(count);
+            }
+        }
+        template<class... Args>
+        SBO_COLD reference grow_emplace_back(Args&&... args) {
+            if (can_realloc_heap())
+                realloc_emplace_back(std::forward<Args>(args)...);
+            else
+                realloc_insert(m_size, 1, [&](T* gap) { construct(gap, std::forward<Args>(args)...); });
+            return back();
+        }
+        //the new element is built outside of the vector first, as the arguments might reference elements which
+        //are invalidated by the reallocation
+        template<class... Args>
+        void realloc_emplace_back(Args&&... args) {
+            alignas(T) std::byte buffer[sizeof(T)];
+            T* element = reinterpret_cast<T*>(buffer);
+            construct(element, std::forward<Args>(args)...);
+            try {
+                note_growth(m_size + 1);
+                realloc_heap(next_capacity(m_size + 1));
+            } catch (...) {
+                destroy(element, element + 1);
+                throw;
+            }
+            memcpy_elements(end(), element, 1);
+            ++m_size;
+        }
+        //moves the elements into a new heap block and lets constructGap construct count new elements at index.
+        //The new elements are constructed first, since the arguments might still reference the old elements.
+        template<typename ConstructGap>
+        void realloc_insert(size_type index, size_type count, ConstructGap&& constructGap) {
+            note_growth(m_size + count);
+            const auto [newBegin, newCapacity] = allocate(next_capacity(m_size + count));
+            T* gap = newBegin + index;
+            try {
+                constructGap(gap);
+            } catch (...) {
+                deallocate(newBegin, newCapacity);
+                throw;
+            }
+            try {
+                relocate_to(newBegin, index, count);
+            } catch (...) {
+                destroy(gap, gap + count);
+                deallocate(newBegin, newCapacity);
+                throw;
+            }
+            replace_storage(newBegin, newCapacity);
+            set_size(m_size + count);
+        }
+        //moves the elements [0, index) to dest and [index, size) to dest + index + gap and ends the lifetime of the
+        //old elements. When an exception is thrown the old elements are left untouched.
+        void relocate_to(T* dest, size_type index, size_type gap) {
+            if constexpr (is_trivially_relocatable_v<T>) {
+                memcpy_elements(dest, m_begin, index);
+                memcpy_elements(dest + index + gap, m_begin + index, m_size - index);
+            } else {
+                T* movedEnd = uninitialized_move_if_noexcept(begin(), begin() + index, dest);
+                try {
+                    uninitialized_move_if_noexcept(begin() + index, end(), dest + index + gap);
+                } catch (...) {
+                    destroy(dest, movedEnd);
+                    throw;
+                }
+                destroy(begin(), end());
+            }
+        }
+        //requires size() <= inline_capacity() and the heap storage to be active
+//GCC doesn't see that size() <= inline_capacity() fits into the small buffer, as N is only known at runtime here
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Warray-bounds"
+#  pragma GCC diagnostic ignored "-Wstringop-overflow"
+#endif
+        void move_to_small_buffer() {
+            const size_type inlineCapacity = inline_capacity();
+            try {
+                if constexpr (is_trivially_relocatable_v<T>)
+                    std::memcpy(static_cast<void*>(inline_buffer()), static_cast<const void*>(m_begin), m_size * sizeof(T));
+                else
+                    relocate_to(inline_buffer(), m_size, 0);
+            } catch (...) {
+                store_inline_capacity(inlineCapacity);
+                throw;
+            }
+            deallocate(m_begin, m_capacity);
+            m_begin = inline_buffer();
+            m_capacity = static_cast<SizeType>(inlineCapacity);
+        }
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+        //destroys the elements [count, size) and moves back into the small buffer if the ShrinkPolicy says so.
+        //This is only done for types which can be moved without exceptions, so that erasing stays noexcept.
+        void truncate(size_type count) noexcept {
+            destroy(begin() + count, end());
+            set_size(count);
+            shrink_by_policy();
+        }
+        void shrink_by_policy() noexcept {
+            if constexpr (is_trivially_relocatable_v<T> 
+                          || (std::is_nothrow_move_constructible_v<T> && !detail::allocator_constructs_v<Alloc, T>)) {
+                if (!is_small()) {
+                    const size_type inlineCapacity = inline_capacity();
+                    if (m_size <= inlineCapacity && ShrinkPolicy::should_shrink(m_size, inlineCapacity))
+                        move_to_small_buffer();
+                }
+            }
+        }
+        //Moves the elements of other into this vector. The heap memory of other is taken over unless preferSmallBuffer
+        //is set and the elements fit into our small buffer (other then keeps its heap memory for later use).
+        void move_assign(small_vector_impl& other, bool preferSmallBuffer) {
+            if (this == &other)
+                return;
+            constexpr bool propagate = alloc_traits::propagate_on_container_move_assignment::value;
+            const bool fitsSmallBuffer = preferSmallBuffer && other.m_size <= inline_capacity();
+            if (!other.is_small() && !fitsSmallBuffer && (propagate || this->alloc() == other.alloc())) {
+                clear();
+                release_heap();
+                if constexpr (propagate)
+                    this->alloc() = other.alloc();
+                steal_heap(other);
+                return;
+            }
+            if constexpr (propagate) {
+                if (this->alloc() != other.alloc()) {
+                    clear();
+                    release_heap();
+                }
+                this->alloc() = other.alloc();
+            }
+            if constexpr (is_trivially_relocatable_v<T>) {
+                clear();
+                if (other.size() > m_capacity) {
+                    note_growth(checked_capacity(other.size()));
+                    const auto [newBegin, newCapacity] = allocate(other.size());
+                    replace_storage(newBegin, newCapacity);
+                }
+                relocate_from(other);
+                return;
+            }
+            //either the elements of other stay out of its heap memory or the allocators differ, so we move element wise
+            assign_n(std::make_move_iterator(other.begin()), other.size());
+            other.clear();
+        }
+        //requires an empty small_vector, which uses an allocator equal to the one of other and enough capacity 
+        //for the elements of other
+        void move_construct_from(small_vector_impl& other) {
+            if (!other.is_small()) {
+                //the heap memory can simply be taken over
+                steal_heap(other);
+            } else {
+                move_elements_from(other);
+            }
+        }
+        //moves the elements of other into our storage, requires an empty small_vector with enough capacity
+        void move_elements_from(small_vector_impl& other) {
+            if constexpr (is_trivially_relocatable_v<T>) {
+                relocate_from(other);
+            } else {
+                uninitialized_move(other.begin(), other.end(), begin());
+                m_size = other.m_size;
+                other.clear();
+            }
+        }
+        //takes over the elements of other byte wise, requires an empty small_vector with enough capacity
+//GCC may assume that the small buffer of other holds more elements than its runtime N allows
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Warray-bounds"
+#  if __GNUC__ >= 11
+#    pragma GCC diagnostic ignored "-Wstringop-overread"
+#  endif
+#endif
+        void relocate_from(small_vector_impl& other) noexcept {
+            std::memcpy(static_cast<void*>(m_begin), static_cast<const void*>(other.m_begin), other.m_size * sizeof(T));
+            other.profile().note_size(other.m_size);
+            m_size = other.m_size;
+            other.m_size = 0;
+        }
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+        //shifts the elements [index, size) one to the right, requires size < capacity
+        void open_gap(size_type index) {
+            construct(end(), std::move(back()));
+            ++m_size;
+            std::move_backward(begin() + index, end() - 2, end() - 1);
+        }
+        //Trivially relocatable elements [index, size) are moved count positions to the right with a single memmove, 
+        //then constructGap constructs the new elements in the gap. Requires size + count <= capacity.
+        template<typename ConstructGap>
+        void shift_insert(size_type index, size_type count, ConstructGap&& constructGap) {
+            T* gap = begin() + index;
+            const size_type bytesAfter = (m_size - index) * sizeof(T);
+            std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), bytesAfter);
+            try {
+                constructGap(gap);
+            } catch (...) {
+                std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), bytesAfter);
+                throw;
+            }
+            set_size(m_size + count);
+        }
+        template<typename ForwardIt>
+        void insert_in_place(size_type index, size_type count, ForwardIt first, ForwardIt last) {
+            if constexpr (is_trivially_relocatable_v<T>) {
+                shift_insert(index, count, [&](T* gap) { uninitialized_copy_n(first, count, gap); });
+            } else {
+                T* pos = begin() + index;
+                T* oldEnd = end();
+                const size_type elemsAfter = m_size - index;
+                if (elemsAfter > count) {
+                    uninitialized_move(oldEnd - count, oldEnd, oldEnd);
+                    set_size(m_size + count);
+                    std::move_backward(pos, oldEnd - count, oldEnd);
+                    std::copy(first, last, pos);
+                } else {
+                    ForwardIt mid = std::next(first, static_cast<difference_type>(elemsAfter));
+                    uninitialized_copy(mid, last, oldEnd);
+                    set_size(m_size + count - elemsAfter);
+                    uninitialized_move(pos, oldEnd, end());
+                    set_size(m_size + elemsAfter);
+                    std::copy(first, mid, pos);
+                }
+            }
+        }
+        //the new elements are copied before the old ones are relocated, first might point into this vector
+        template<typename ForwardIt>
+        void append_n(ForwardIt first, size_type count) {
+            if (m_size + count > m_capacity) {
+                realloc_insert(m_size, count, [&](T* gap) { uninitialized_copy_n(first, count, gap); });
+            } else {
+                uninitialized_copy_n(first, count, end());
+                set_size(m_size + count);
+            }
+        }
+        //assigns count elements from first, reusing the current storage if possible
+        template<typename ForwardIt>
+        void assign_n(ForwardIt first, size_type count) {
+            if (count > m_capacity) {
+                //the new elements don't fit, so don't bother assigning to the old ones
+                note_growth(checked_capacity(count));
+                clear();
+                const auto [newBegin, newCapacity] = allocate(count);
+                replace_storage(newBegin, newCapacity);
+                uninitialized_copy_n(first, count, begin());
+                set_size(count);
+                return;
+            }
+            const size_type common = std::min(size(), count);
+            for (size_type i = 0; i < common; ++i, ++first)
+                m_begin[i] = *first;
+            if (count > m_size)
+                uninitialized_copy_n(first, count - m_size, end());
+            else
+                destroy(begin() + count, end());
+            set_size(count);
+        }
+        void release_heap() noexcept {
+            if (!is_small()) {
+                const size_type inlineCapacity = inline_capacity();
+                deallocate(m_begin, m_capacity);
+                m_begin = inline_buffer();
+                m_capacity = static_cast<SizeType>(inlineCapacity);
+            }
+        }
+        //requires an empty small_vector which uses its small buffer, other continues with its small buffer
+        void steal_heap(small_vector_impl& other) noexcept {
+            other.profile().note_size(other.m_size);
+            store_inline_capacity(m_capacity);
+            const size_type otherInlineCapacity = other.inline_capacity();
+            m_begin = other.m_begin;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_begin = other.inline_buffer();
+            other.m_size = 0;
+            other.m_capacity = static_cast<SizeType>(otherInlineCapacity);
+        }
+        //our elements are relocated into the unused small buffer of other, which hands its heap memory over to us.
+        //Requires our small buffer to be active and our elements to fit into the small buffer of other.
+        void swap_small_with_heap(small_vector_impl& other) {
+            const size_type inlineCapacity = m_capacity;
+            const size_type otherInlineCapacity = other.inline_capacity();
+            try {
+                relocate_to(other.inline_buffer(), m_size, 0);
+            } catch (...) {
+                other.store_inline_capacity(otherInlineCapacity);
+                throw;
+            }
+            store_inline_capacity(inlineCapacity);
+            m_begin = other.m_begin;
+            other.m_begin = other.inline_buffer();
+            std::swap(m_size, other.m_size);
+            m_capacity = other.m_capacity;
+            other.m_capacity = static_cast<SizeType>(otherInlineCapacity);
+        }
+
+        T* m_begin;
+        SizeType m_size = 0;
+        SizeType m_capacity;
     };
+
+    //small_vector manages its storage itself: a pointer to the first element, the size and the capacity.
+    //A default constructed small_vector simply points to the small buffer, so no allocator call or reserve is
+    //needed. Once more than N elements are needed, the elements are moved to the heap (just like std::vector does).
+    //Alloc is only used for the heap memory, stateless allocators don't take any space.
+    //SizeType is the type used to store the size and the capacity, a smaller type (e.g. uint32_t) makes the
+    //small_vector more compact at the cost of a smaller max_size().
+    //ShrinkPolicy allows to release the heap memory automatically when the elements fit into the small buffer again.
+    //GrowthPolicy decides how the capacity grows once the small buffer is exhausted.
+    //All members except the constructors and swap are implemented by small_vector_impl, which doesn't depend on N.
+    template<typename T, size_t N = 8, typename Alloc = std::allocator<T>, typename SizeType = std::size_t, 
+             typename ShrinkPolicy = never_shrink, typename GrowthPolicy = grow_double>
+    class small_vector : public small_vector_impl<T, Alloc, SizeType, ShrinkPolicy, GrowthPolicy> {
+        using impl = small_vector_impl<T, Alloc, SizeType, ShrinkPolicy, GrowthPolicy>;
+        using alloc_traits = std::allocator_traits<Alloc>;
+        static_assert(N > 0 && N <= std::numeric_limits<SizeType>::max(), "N doesn't fit into SizeType");
+    public:
+        using typename impl::size_type;
+
+        small_vector(SBO_SITE_ONLY_PARAM) noexcept(std::is_nothrow_default_constructible_v<Alloc>) : impl(N SBO_SITE_ARG) {}
+        explicit small_vector(const Alloc& alloc SBO_SITE_PARAM) noexcept : impl(N, alloc SBO_SITE_ARG) {}
+        //the constructors allocate at most once and exactly the needed capacity (without the growth policy)
+        explicit small_vector(size_type count, const Alloc& alloc = Alloc() SBO_SITE_PARAM) : small_vector(alloc SBO_SITE_ARG) { 
+            this->reserve(count);
+            this->resize(count); 
+        }
+        small_vector(size_type count, default_init_t, const Alloc& alloc = Alloc() SBO_SITE_PARAM) : small_vector(alloc SBO_SITE_ARG) { 
+            this->reserve(count);
+            this->resize_for_overwrite(count); 
+        }
+        small_vector(size_type count, const T& value, const Alloc& alloc = Alloc() SBO_SITE_PARAM) : small_vector(alloc SBO_SITE_ARG) {
+            this->assign(count, value);
+        }
+        template<class InputIt, typename = detail::enable_if_iterator_t<InputIt>>
+        small_vector(InputIt first, InputIt last, const Alloc& alloc = Alloc() SBO_SITE_PARAM) : small_vector(alloc SBO_SITE_ARG) {
+            this->assign(first, last);
+        }
+        small_vector(std::initializer_list<T> init, const Alloc& alloc = Alloc() SBO_SITE_PARAM) : small_vector(alloc SBO_SITE_ARG) {
+            this->assign(init.begin(), init.end());
+        }
+        small_vector(const small_vector& other SBO_SITE_PARAM) 
+            : small_vector(other, alloc_traits::select_on_container_copy_construction(other.get_allocator()) SBO_SITE_ARG) {}
+        small_vector(const small_vector& other, const Alloc& alloc SBO_SITE_PARAM) : small_vector(alloc SBO_SITE_ARG) {
+            this->assign_n(other.begin(), other.size());
+        }
+        small_vector(small_vector&& other SBO_SITE_PARAM) noexcept(std::is_nothrow_move_constructible_v<T>) 
+            : small_vector(other.get_allocator() SBO_SITE_ARG) {
+            this->move_construct_from(other);
+        }
+        small_vector(small_vector&& other, const Alloc& alloc SBO_SITE_PARAM) : small_vector(alloc SBO_SITE_ARG) {
+            if (other.is_small() || alloc == other.get_allocator())
+                this->move_construct_from(other);
+            else
+                this->assign_n(std::make_move_iterator(other.begin()), other.size());
+        }
+        //Takes over the heap memory of a small_vector with a different N in O(1) when its elements don't fit into our
+        //small buffer. Otherwise the elements are moved into the small buffer and other keeps its heap memory.
+        small_vector(impl&& other SBO_SITE_PARAM) : small_vector(other.get_allocator() SBO_SITE_ARG) {
+            if (other.size() <= N) {
+                this->move_elements_from(other);
+            } else {
+                if (other.is_small())
+                    this->reserve(other.size());
+                this->move_construct_from(other);
+            }
+        }
+        ~small_vector() {
+            static_assert(offsetof_small_buffer() == impl::inline_buffer_offset(), "the small buffer has to follow small_vector_impl");
+            this->profile().template record<small_vector, T, N>(this->m_size);
+        }
+
+        small_vector& operator=(const small_vector& other) {
+            impl::operator=(other);
+            return *this;
+        }
+        small_vector& operator=(small_vector&& other) noexcept(
+            (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
+            && std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+            this->move_assign(other, false);
+            return *this;
+        }
+        small_vector& operator=(impl&& other) {
+            impl::operator=(std::move(other));
+            return *this;
+        }
+        small_vector& operator=(std::initializer_list<T> init) {
+            this->assign(init.begin(), init.end());
+            return *this;
+        }
+
+        //Heap memory is exchanged in O(1). Elements in the small buffers are swapped byte wise for trivially relocatable
+        //types and element wise otherwise. Unequal allocators which don't propagate can't exchange their heap memory, 
+        //in that case the elements are moved.
+        void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>
+            && (alloc_traits::propagate_on_container_swap::value || alloc_traits::is_always_equal::value)) {
+            if (this == &other)
+                return;
+            this->profile().note_size(this->m_size);
+            other.profile().note_size(other.m_size);
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(this->alloc(), other.alloc());
+            } else if (!(this->is_small() && other.is_small()) && this->get_allocator() != other.get_allocator()) {
+                small_vector tmp(std::move(other));
+                other = std::move(*this);
+                *this = std::move(tmp);
+                return;
+            }
+            if (!this->is_small() && !other.is_small()) {
+                std::swap(this->m_begin, other.m_begin);
+                std::swap(this->m_size, other.m_size);
+                std::swap(this->m_capacity, other.m_capacity);
+            } else if (this->is_small() && other.is_small()) {
+                swap_small_buffers(other);
+            } else if (this->is_small()) {
+                this->swap_small_with_heap(other);
+            } else {
+                other.swap_small_with_heap(*this);
+            }
+        }
+        friend void swap(small_vector& a, small_vector& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+    private:
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+        static constexpr size_t offsetof_small_buffer() noexcept { return offsetof(small_vector, m_smallBuffer); }
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+//the unused part of the small buffers is copied as well
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+        void swap_small_buffers(small_vector& other) {
+            if constexpr (is_trivially_relocatable_v<T>) {
+                //small buffers are swapped completely, a fixed size compiles to a few vector moves
+                constexpr size_type maxFixedBytes = 128;
+                const size_type bytes = sizeof(m_smallBuffer) <= maxFixedBytes ? sizeof(m_smallBuffer) 
+                                                                               : std::max(this->size(), other.size()) * sizeof(T);
+                alignas(alignof(T)) std::byte tmp[sizeof(m_smallBuffer)];
+                std::memcpy(tmp, m_smallBuffer, bytes);
+                std::memcpy(m_smallBuffer, other.m_smallBuffer, bytes);
+                std::memcpy(other.m_smallBuffer, tmp, bytes);
+                std::swap(this->m_size, other.m_size);
+            } else {
+                small_vector& shorter = this->m_size < other.m_size ? *this : other;
+                small_vector& longer = this->m_size < other.m_size ? other : *this;
+                const size_type common = shorter.size();
+                std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+                shorter.uninitialized_move(longer.begin() + common, longer.end(), shorter.end());
+                shorter.set_size(longer.size());
+                longer.destroy(longer.begin() + common, longer.end());
+                longer.set_size(common);
+            }
+        }
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
+        //at least large enough to store N while the heap memory is used, which doesn't change sizeof(small_vector)
+        alignas(alignof(T)) std::byte m_smallBuffer[std::max(N * sizeof(T), sizeof(SizeType))];
+    };
+
+    //small_vector with 32 bit size and capacity, which saves 8 bytes on 64 bit platforms
+    template<typename T, size_t N = 8, typename SizeType = std::uint32_t, typename Alloc = std::allocator<T>>
+    using compact_small_vector = small_vector<T, N, Alloc, SizeType>;
+
+    //Size of a cache line, 64 unless SBO_CACHE_LINE_SIZE is defined (e.g. as 128 for Apple's ARM cores). It doesn't use
+    //std::hardware_destructive_interference_size, which changes with -mtune/-march (GCC uses 256 for aarch64), so the
+    //layout of small_vector_bytes could differ between translation units.
+#if defined(SBO_CACHE_LINE_SIZE)
+    inline constexpr size_t cache_line_size = SBO_CACHE_LINE_SIZE;
+#else
+    inline constexpr size_t cache_line_size = 64;
+#endif
+
+    namespace detail {
+        //largest N for which small_vector<T, N, ...> takes at most Bytes, starting at an upper bound which ignores
+        //the padding and the allocator
+        template<size_t Bytes, typename T, size_t N, typename... Params>
+        constexpr size_t fitting_capacity() noexcept {
+            if constexpr (N <= 1 || sizeof(small_vector<T, N, Params...>) <= Bytes)
+                return N;
+            else
+                return fitting_capacity<Bytes, T, N - 1, Params...>();
+        }
+        template<typename T, size_t Bytes, typename Alloc, typename SizeType, typename ShrinkPolicy, typename GrowthPolicy>
+        constexpr size_t capacity_for_bytes() noexcept {
+            constexpr size_t header = sizeof(T*) + 2 * sizeof(SizeType);
+            constexpr size_t upperBound = Bytes > header ? (Bytes - header) / sizeof(T) : 0;
+            return fitting_capacity<Bytes, T, std::max<size_t>(upperBound, 1), Alloc, SizeType, ShrinkPolicy, GrowthPolicy>();
+        }
+    }
+
+    //small_vector which takes exactly Bytes (by default one cache line), N is the largest capacity that fits.
+    //It is aligned to the cache line size, so every instance starts at a cache line and arrays of them never share
+    //a line between two elements (no false sharing, no element straddles two lines).
+    template<typename T, size_t Bytes = cache_line_size, typename Alloc = std::allocator<T>, typename SizeType = std::size_t,
+             typename ShrinkPolicy = never_shrink, typename GrowthPolicy = grow_double>
+    class alignas(std::max(cache_line_size, alignof(T))) small_vector_bytes 
+        : public small_vector<T, detail::capacity_for_bytes<T, Bytes, Alloc, SizeType, ShrinkPolicy, GrowthPolicy>(), 
+                              Alloc, SizeType, ShrinkPolicy, GrowthPolicy> {
+        static_assert(Bytes % cache_line_size == 0, "Bytes has to be a multiple of the cache line size");
+    public:
+        //N of the small_vector, a compile time constant unlike inline_capacity()
+        static constexpr size_t static_capacity = detail::capacity_for_bytes<T, Bytes, Alloc, SizeType, ShrinkPolicy, GrowthPolicy>();
+        using vector_type = small_vector<T, static_capacity, Alloc, SizeType, ShrinkPolicy, GrowthPolicy>;
+        static_assert(sizeof(vector_type) <= Bytes, "not even a single element fits into Bytes");
+
+        using vector_type::vector_type;
+        using vector_type::operator=;
+        small_vector_bytes() = default;
+    };
+
+#if defined(__cpp_lib_memory_resource)
+    namespace pmr {
+        //The small buffer is used first, the heap memory comes from a std::pmr::memory_resource (e.g. a
+        //monotonic_buffer_resource). Nested pmr containers are constructed with the memory resource of the outer one.
+        template<typename T, size_t N = 8>
+        using small_vector = sbo::small_vector<T, N, std::pmr::polymorphic_allocator<T>>;
+    }
+#endif
 }
+
+#undef SBO_LIKELY
+#undef SBO_COLD
+#undef SBO_SITE_DECL
+#undef SBO_SITE_ONLY_PARAM
+#undef SBO_SITE_PARAM
+#undef SBO_SITE_ARG
+#undef SBO_SITE_INIT
@@ -0,0 +1,102 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#pragma once
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace sbo{
+
+    //Sorting networks for small sizes, which are generated at compile time. A network is a fixed sequence of
+    //compare exchanges, so sorting doesn't branch on the data (unlike the partitioning and the insertion sort of
+    //std::sort) and the compare exchanges of arithmetic types compile to min/max or conditional moves.
+    namespace detail::network {
+        struct comparator {
+            size_t lo;
+            size_t hi;
+        };
+
+        //Batcher's odd-even merge sort for the next power of two. The comparators touching the indices >= Size are
+        //left out, which sorts Size elements (the missing elements act like maximal elements at the end).
+        template<typename Visit>
+        constexpr void for_each_comparator(size_t size, Visit&& visit) {
+            size_t powerOfTwo = 1;
+            while (powerOfTwo < size)
+                powerOfTwo *= 2;
+            for (size_t p = 1; p < powerOfTwo; p *= 2) {
+                for (size_t k = p; k >= 1; k /= 2) {
+                    for (size_t j = k % p; j + k < powerOfTwo; j += 2 * k) {
+                        for (size_t i = 0; i < k && i + j + k < powerOfTwo; ++i) {
+                            if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < size)
+                                visit(comparator{i + j, i + j + k});
+                        }
+                    }
+                }
+            }
+        }
+        constexpr size_t comparator_count(size_t size) {
+            size_t count = 0;
+            for_each_comparator(size, [&count](comparator) { ++count; });
+            return count;
+        }
+        template<size_t Size>
+        constexpr auto make_comparators() {
+            std::array<comparator, comparator_count(Size)> comparators{};
+            size_t index = 0;
+            for_each_comparator(Size, [&](comparator c) { comparators[index++] = c; });
+            return comparators;
+        }
+        template<size_t Size>
+        inline constexpr auto comparators_v = make_comparators<Size>();
+
+        //arithmetic types select both results without a branch, other types are swapped when they are out of order
+        template<typename T, typename Compare>
+        inline void compare_exchange(T& lo, T& hi, Compare& comp) {
+            if constexpr (std::is_arithmetic_v<T>) {
+                const bool outOfOrder = comp(hi, lo);
+                const T min = outOfOrder ? hi : lo;
+                const T max = outOfOrder ? lo : hi;
+                lo = min;
+                hi = max;
+            } else {
+                if (comp(hi, lo)) {
+                    using std::swap;
+                    swap(lo, hi);
+                }
+            }
+        }
+
+        template<size_t Size, typename T, typename Compare, size_t... I>
+        inline void sort_fixed(T* data, Compare& comp, std::index_sequence<I...>) {
+            constexpr auto& comparators = comparators_v<Size>;
+            //the networks for 0 and 1 elements are empty
+            static_cast<void>(comparators);
+            static_cast<void>(data);
+            static_cast<void>(comp);
+            (compare_exchange(data[comparators[I].lo], data[comparators[I].hi], comp), ...);
+        }
+        template<size_t Size, typename T, typename Compare>
+        void sort_fixed(T* data, Compare& comp) {
+            sort_fixed<Size>(data, comp, std::make_index_sequence<comparators_v<Size>.size()>{});
+        }
+
+        template<typename T, typename Compare>
+        using sort_function = void (*)(T*, Compare&);
+        template<typename T, typename Compare, size_t... Size>
+        constexpr std::array<sort_function<T, Compare>, sizeof...(Size)> make_sort_table(std::index_sequence<Size...>) {
+            return {&sort_fixed<Size, T, Compare>...};
+        }
+
+        //largest size which is sorted with a network
+        inline constexpr size_t max_size = 32;
+
+        //sorts size <= MaxSize elements with the network of exactly that size
+        template<size_t MaxSize, typename T, typename Compare>
+        void sort(T* data, size_t size, Compare& comp) {
+            static_assert(MaxSize <= max_size, "the networks get too large");
+            static constexpr auto table = make_sort_table<T, Compare>(std::make_index_sequence<MaxSize + 1>{});
+            table[size](data, comp);
+        }
+    }
+}
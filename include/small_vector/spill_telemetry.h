@@ -0,0 +1,198 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Counters for the heap allocations of small_vector, one set per <T, N>. They show how often the small buffer is left
+//for the heap, how often the heap memory grows afterwards and which sizes are needed, to pick N from production data.
+//small_vector.h only records the allocations when SBO_SPILL_TELEMETRY is defined (CMake option
+//SMALL_VECTOR_SPILL_TELEMETRY), it has to be defined for all translation units of the program.
+
+namespace sbo{
+
+    //snapshot of the counters of one <T, N>
+    struct spill_stats {
+        std::string_view type;
+        size_t n = 0;
+        //moves from the small buffer to the heap
+        uint64_t spills = 0;
+        //growths of the heap memory after the first spill
+        uint64_t reallocations = 0;
+        uint64_t maxRequested = 0;
+        //histogram[i] counts the requested capacities with i significant bits, i.e. in [2^(i-1), 2^i)
+        uint64_t histogram[65] = {};
+    };
+
+    namespace detail {
+        //name of T, parsed from the function signature (without RTTI)
+        template<typename T>
+        std::string_view type_name() noexcept {
+#if defined(__clang__) || defined(__GNUC__)
+            const std::string_view signature = __PRETTY_FUNCTION__;
+            const size_t first = signature.find("T = ") + 4;
+            const size_t last = signature.find_first_of(";]", first);
+#elif defined(_MSC_VER)
+            const std::string_view signature = __FUNCSIG__;
+            const size_t first = signature.find("type_name<") + 10;
+            const size_t last = signature.rfind(">(void)");
+#else
+            const std::string_view signature = "unknown";
+            const size_t first = 0;
+            const size_t last = signature.size();
+#endif
+            return signature.substr(first, last - first);
+        }
+
+        //counters of one <T, N>, all instances are linked into a list for spill_telemetry()
+        class spill_counters {
+        public:
+            spill_counters(std::string_view type, size_t n, spill_counters* nextOfType) noexcept
+                : m_nextOfType(nextOfType), m_type(type), m_n(n) {
+                m_next = s_head.load(std::memory_order_relaxed);
+                while (!s_head.compare_exchange_weak(m_next, this, std::memory_order_release, std::memory_order_relaxed)) {}
+            }
+
+            //requested is the needed capacity, firstSpill whether the small buffer is left
+            void record(size_t requested, bool firstSpill) noexcept {
+                (firstSpill ? m_spills : m_reallocations).fetch_add(1, std::memory_order_relaxed);
+                m_histogram[bit_width(requested)].fetch_add(1, std::memory_order_relaxed);
+                uint64_t maxRequested = m_maxRequested.load(std::memory_order_relaxed);
+                while (requested > maxRequested
+                       && !m_maxRequested.compare_exchange_weak(maxRequested, requested, std::memory_order_relaxed)) {}
+            }
+            spill_stats snapshot() const noexcept {
+                spill_stats stats;
+                stats.type = m_type;
+                stats.n = m_n;
+                stats.spills = m_spills.load(std::memory_order_relaxed);
+                stats.reallocations = m_reallocations.load(std::memory_order_relaxed);
+                stats.maxRequested = m_maxRequested.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < std::size(m_histogram); ++i)
+                    stats.histogram[i] = m_histogram[i].load(std::memory_order_relaxed);
+                return stats;
+            }
+            void reset() noexcept {
+                m_spills.store(0, std::memory_order_relaxed);
+                m_reallocations.store(0, std::memory_order_relaxed);
+                m_maxRequested.store(0, std::memory_order_relaxed);
+                for (auto& bucket : m_histogram)
+                    bucket.store(0, std::memory_order_relaxed);
+            }
+
+            static spill_counters* first() noexcept { return s_head.load(std::memory_order_acquire); }
+            spill_counters* next() const noexcept { return m_next; }
+            //list of the counters with the same T, see spill_counters_for
+            spill_counters* next_of_type() const noexcept { return m_nextOfType; }
+            size_t n() const noexcept { return m_n; }
+
+        private:
+            static size_t bit_width(size_t n) noexcept {
+                size_t width = 0;
+                for (; n != 0; n >>= 1)
+                    ++width;
+                return width;
+            }
+
+            static inline std::atomic<spill_counters*> s_head{nullptr};
+            spill_counters* m_next = nullptr;
+            spill_counters* m_nextOfType;
+            std::string_view m_type;
+            size_t m_n;
+            std::atomic<uint64_t> m_spills{0};
+            std::atomic<uint64_t> m_reallocations{0};
+            std::atomic<uint64_t> m_maxRequested{0};
+            std::atomic<uint64_t> m_histogram[65] = {};
+        };
+
+        //The growth path of small_vector_impl only knows N at runtime (inline_capacity()), so the counters of a T are
+        //kept in a list. Only adding the counters of a new N takes a lock, they live until the program ends.
+        template<typename T>
+        spill_counters& spill_counters_for(size_t n) {
+            static std::atomic<spill_counters*> s_first{nullptr};
+            static std::mutex s_mutex;
+            const auto find = [n]() -> spill_counters* {
+                for (spill_counters* counters = s_first.load(std::memory_order_acquire); counters; counters = counters->next_of_type()) {
+                    if (counters->n() == n)
+                        return counters;
+                }
+                return nullptr;
+            };
+            if (spill_counters* counters = find())
+                return *counters;
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (spill_counters* counters = find())
+                return *counters;
+            auto* counters = new spill_counters(type_name<T>(), n, s_first.load(std::memory_order_relaxed));
+            s_first.store(counters, std::memory_order_release);
+            return *counters;
+        }
+        template<typename T, size_t N>
+        spill_counters& spill_counters_for() {
+            static spill_counters& counters = spill_counters_for<T>(N);
+            return counters;
+        }
+
+        inline void write_json_string(std::ostream& out, std::string_view str) {
+            out << '"';
+            for (const char c : str) {
+                if (c == '"' || c == '\\')
+                    out << '\\';
+                out << c;
+            }
+            out << '"';
+        }
+    }
+
+    //counters of small_vector<T, N, ...>
+    template<typename T, size_t N>
+    spill_stats spill_telemetry_for() { return detail::spill_counters_for<T, N>().snapshot(); }
+
+    //counters of all <T, N> which allocated at least once
+    inline std::vector<spill_stats> spill_telemetry() {
+        std::vector<spill_stats> stats;
+        for (const detail::spill_counters* counters = detail::spill_counters::first(); counters; counters = counters->next())
+            stats.push_back(counters->snapshot());
+        return stats;
+    }
+
+    inline void reset_spill_telemetry() noexcept {
+        for (detail::spill_counters* counters = detail::spill_counters::first(); counters; counters = counters->next())
+            counters->reset();
+    }
+
+    //[{"type": "int", "n": 8, "spills": 10, "reallocations": 2, "max_requested": 40, "log2_histogram": [0, 0, 0, 0, 8, 3, 1]}, ...]
+    //the histogram ends with the last non empty bucket
+    inline void write_spill_telemetry_json(std::ostream& out) {
+        out << '[';
+        bool firstEntry = true;
+        for (const spill_stats& stats : spill_telemetry()) {
+            out << (firstEntry ? "" : ", ") << "{\"type\": ";
+            detail::write_json_string(out, stats.type);
+            out << ", \"n\": " << stats.n << ", \"spills\": " << stats.spills
+                << ", \"reallocations\": " << stats.reallocations << ", \"max_requested\": " << stats.maxRequested
+                << ", \"log2_histogram\": [";
+            size_t buckets = std::size(stats.histogram);
+            while (buckets > 0 && stats.histogram[buckets - 1] == 0)
+                --buckets;
+            for (size_t i = 0; i < buckets; ++i)
+                out << (i == 0 ? "" : ", ") << stats.histogram[i];
+            out << "]}";
+            firstEntry = false;
+        }
+        out << ']';
+    }
+    inline std::string spill_telemetry_json() {
+        std::ostringstream out;
+        write_spill_telemetry_json(out);
+        return out.str();
+    }
+}
@@ -0,0 +1,152 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#pragma once
+#include <small_vector/small_vector.h>
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace sbo{
+
+    //Per thread cache of freed heap blocks. Blocks up to max_block_size bytes are rounded up to a power of two (the
+    //size class) and kept in a free list per class when they are deallocated, so the next allocation of the same
+    //class on this thread doesn't call operator new. Spills of small_vectors have very repetitive sizes (2N, 4N, 8N),
+    //so most of them are served from the cache, without any lock or remote free in the global allocator.
+    //The cached bytes of a thread are limited by byte_limit(), the blocks are returned to operator delete when the
+    //thread exits or flush() is called. Blocks can be deallocated by any thread, they end up in the cache of that thread.
+    class thread_cache {
+    public:
+        static constexpr size_t min_block_size = 16;
+        static constexpr size_t max_block_size = size_t(1) << 16;
+        static constexpr size_t default_byte_limit = size_t(1) << 18;
+
+        //the block holds at least bytes, count is the usable size (the size class)
+        [[nodiscard]] static allocation_result<void*> allocate(size_t bytes) {
+            if (bytes > max_block_size)
+                return {::operator new(bytes), bytes};
+            state& s = local();
+            const size_t index = class_index(bytes);
+            const size_t blockSize = min_block_size << index;
+            if (free_block* block = s.freeLists[index]) {
+                s.freeLists[index] = block->next;
+                s.cachedBytes -= blockSize;
+                return {block, blockSize};
+            }
+            return {::operator new(blockSize), blockSize};
+        }
+        //bytes can be anything between the requested and the returned size of the allocation
+        static void deallocate(void* p, size_t bytes) noexcept {
+            if (bytes <= max_block_size) {
+                state& s = local();
+                const size_t index = class_index(bytes);
+                const size_t blockSize = min_block_size << index;
+                if (s.cachedBytes + blockSize <= s.byteLimit) {
+                    if (!s.hasExitGuard)
+                        register_exit_guard();
+                    s.freeLists[index] = ::new (p) free_block{s.freeLists[index]};
+                    s.cachedBytes += blockSize;
+                    return;
+                }
+            }
+            ::operator delete(p);
+        }
+
+        //returns all cached blocks of the calling thread to operator delete
+        static void flush() noexcept {
+            state& s = local();
+            for (free_block*& list : s.freeLists) {
+                while (free_block* block = list) {
+                    list = block->next;
+                    ::operator delete(block);
+                }
+            }
+            s.cachedBytes = 0;
+        }
+        //limits the cached bytes of the calling thread, 0 disables the cache
+        static void set_byte_limit(size_t bytes) noexcept {
+            state& s = local();
+            s.byteLimit = bytes;
+            if (s.cachedBytes > bytes)
+                flush();
+        }
+        static size_t byte_limit() noexcept { return local().byteLimit; }
+        static size_t cached_bytes() noexcept { return local().cachedBytes; }
+
+    private:
+        static constexpr size_t class_count = 13;
+        static constexpr int min_block_log2 = 4;
+        static_assert(size_t(1) << min_block_log2 == min_block_size);
+        static_assert(min_block_size << (class_count - 1) == max_block_size);
+
+        struct free_block {
+            free_block* next;
+        };
+        //trivially destructible, so deallocations from thread_local objects which are destroyed after the
+        //exit_guard still work (they go to operator delete, as the limit is 0 then)
+        struct state {
+            free_block* freeLists[class_count];
+            size_t cachedBytes;
+            size_t byteLimit;
+            bool hasExitGuard;
+        };
+        struct exit_guard {
+            ~exit_guard() {
+                flush();
+                local().byteLimit = 0;
+            }
+        };
+
+        static state& local() noexcept {
+            thread_local state s{{}, 0, default_byte_limit, false};
+            return s;
+        }
+        //the guard is only needed once a block is cached, this keeps its initialization check out of the fast path
+#if defined(__GNUC__) || defined(__clang__)
+        [[gnu::noinline]]
+#endif
+        static void register_exit_guard() noexcept {
+            thread_local exit_guard guard;
+            static_cast<void>(guard);
+            local().hasExitGuard = true;
+        }
+        static size_t class_index(size_t bytes) noexcept {
+            if (bytes <= min_block_size)
+                return 0;
+#if defined(__GNUC__) || defined(__clang__)
+            //index of the highest bit of bytes - 1, relative to min_block_size
+            return static_cast<size_t>(std::numeric_limits<unsigned long long>::digits - __builtin_clzll(bytes - 1) - min_block_log2);
+#else
+            size_t index = 0;
+            while ((min_block_size << index) < bytes)
+                ++index;
+            return index;
+#endif
+        }
+    };
+
+    //Allocator that uses thread_cache, e.g. as the allocator of a small_vector or as the upstream allocator of
+    //small_buffer_vector_allocator. allocate_at_least reports the whole size class, which small_vector uses as capacity.
+    template<typename T>
+    struct thread_cache_allocator {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "operator new doesn't support over aligned types");
+        using value_type = T;
+
+        constexpr thread_cache_allocator() noexcept = default;
+        template<class U>
+        constexpr thread_cache_allocator(const thread_cache_allocator<U>&) noexcept {}
+
+        [[nodiscard]] T* allocate(const size_t n) { return allocate_at_least(n).ptr; }
+        [[nodiscard]] allocation_result<T*> allocate_at_least(const size_t n) {
+            if (n > max_size())
+                throw std::bad_array_new_length();
+            const auto result = thread_cache::allocate(n * sizeof(T));
+            return {static_cast<T*>(result.ptr), result.count / sizeof(T)};
+        }
+        void deallocate(T* p, const size_t n) noexcept { thread_cache::deallocate(p, n * sizeof(T)); }
+        static constexpr size_t max_size() noexcept { return std::numeric_limits<size_t>::max() / sizeof(T); }
+
+        friend constexpr bool operator==(const thread_cache_allocator&, const thread_cache_allocator&) noexcept { return true; }
+        friend constexpr bool operator!=(const thread_cache_allocator&, const thread_cache_allocator&) noexcept { return false; }
+    };
+}
@@ -0,0 +1,161 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#include <doctest/doctest.h>
+#include <small_vector/algorithm.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    template<typename Vec>
+    void check_against_std(const Vec& vec, typename Vec::value_type value) {
+        CHECK(sbo::find(vec, value) == std::find(vec.begin(), vec.end(), value));
+        CHECK(sbo::index_of(vec, value) == static_cast<size_t>(std::find(vec.begin(), vec.end(), value) - vec.begin()));
+        CHECK(sbo::count(vec, value) == static_cast<size_t>(std::count(vec.begin(), vec.end(), value)));
+        CHECK(sbo::contains(vec, value) == (std::find(vec.begin(), vec.end(), value) != vec.end()));
+    }
+
+    //sizes around the vector widths, inside the small buffer and on the heap
+    template<typename T, size_t N>
+    void check_random_vectors() {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> dist(0, 9);
+        for (size_t size = 0; size <= 3 * N; ++size) {
+            sbo::small_vector<T, N> vec;
+            for (size_t i = 0; i < size; ++i)
+                vec.push_back(static_cast<T>(dist(rng)));
+            for (int value = 0; value <= 10; ++value)
+                check_against_std(vec, static_cast<T>(value));
+        }
+    }
+}
+
+TEST_CASE("simd_find_and_count_match_std") {
+    check_random_vectors<int8_t, 32>();
+    check_random_vectors<uint8_t, 7>();
+    check_random_vectors<int16_t, 16>();
+    check_random_vectors<uint16_t, 5>();
+    check_random_vectors<int32_t, 8>();
+    check_random_vectors<uint32_t, 3>();
+    check_random_vectors<int64_t, 4>();
+    check_random_vectors<uint64_t, 9>();
+    check_random_vectors<float, 8>();
+    check_random_vectors<double, 4>();
+    check_random_vectors<double, 5>();
+}
+
+TEST_CASE("simd_find_ignores_elements_behind_size") {
+    //the small buffer still contains the popped values, they must not be found
+    sbo::small_vector<int, 16> vec{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    vec.resize(3);
+    REQUIRE(vec.is_small());
+    CHECK(sbo::index_of(vec, 2) == 1);
+    CHECK(sbo::index_of(vec, 4) == 3);
+    CHECK(sbo::find(vec, 16) == vec.end());
+    CHECK_FALSE(sbo::contains(vec, 9));
+    CHECK(sbo::count(vec, 9) == 0);
+    vec.assign(16, 7);
+    vec.resize(5);
+    CHECK(sbo::count(vec, 7) == 5);
+    vec.clear();
+    CHECK(sbo::find(vec, 7) == vec.end());
+    CHECK(sbo::count(vec, 7) == 0);
+}
+
+TEST_CASE("simd_find_compares_floats_with_equality") {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    sbo::small_vector<float, 8> vec{1.f, nan, -0.f, 3.f, 0.f};
+    CHECK_FALSE(sbo::contains(vec, nan));
+    CHECK(sbo::index_of(vec, 0.f) == 2);
+    CHECK(sbo::count(vec, 0.f) == 2);
+    CHECK(sbo::count(vec, -0.f) == 2);
+}
+
+TEST_CASE("find_and_count_other_types") {
+    sbo::small_vector<std::string, 2> vec{"a", "b", "a"};
+    CHECK(sbo::index_of(vec, std::string("b")) == 1);
+    CHECK(sbo::count(vec, std::string("a")) == 2);
+    CHECK_FALSE(sbo::contains(vec, std::string("c")));
+    const auto& constVec = vec;
+    CHECK(sbo::find(constVec, std::string("a")) == constVec.begin());
+}
+
+TEST_CASE("find_and_count_convert_the_value_to_the_element_type") {
+    sbo::small_vector<long, 8> longs{1, 2, 3};
+    CHECK(sbo::contains(longs, 2));
+    CHECK(sbo::index_of(longs, 3) == 2);
+    sbo::small_vector<uint8_t, 16> bytes{7, 8, 7};
+    CHECK(sbo::count(bytes, 7) == 2);
+    CHECK(sbo::find(bytes, 8) == bytes.begin() + 1);
+    const sbo::small_vector<short, 4> shorts{4, 5};
+    CHECK(sbo::find(shorts, 5) == shorts.begin() + 1);
+    sbo::small_vector<size_t, 4> sizes{10, 20};
+    CHECK_FALSE(sbo::contains(sizes, 30));
+    sbo::small_vector<std::string, 2> strings{"a", "b"};
+    CHECK(sbo::index_of(strings, "b") == 1);
+}
+
+//a comparator network sorts all inputs if it sorts all inputs of zeros and ones (0-1 principle)
+template<size_t Size>
+void check_network_sorts_all_binary_inputs() {
+    for (uint32_t bits = 0; bits < (uint32_t(1) << Size); ++bits) {
+        std::array<int, Size> values{};
+        for (size_t i = 0; i < Size; ++i)
+            values[i] = static_cast<int>((bits >> i) & 1u);
+        std::less<> comp;
+        sbo::detail::network::sort_fixed<Size>(values.data(), comp);
+        CHECK(std::is_sorted(values.begin(), values.end()));
+    }
+}
+
+TEST_CASE("sorting_networks_sort_all_binary_inputs") {
+    check_network_sorts_all_binary_inputs<1>();
+    check_network_sorts_all_binary_inputs<2>();
+    check_network_sorts_all_binary_inputs<3>();
+    check_network_sorts_all_binary_inputs<5>();
+    check_network_sorts_all_binary_inputs<7>();
+    check_network_sorts_all_binary_inputs<8>();
+    check_network_sorts_all_binary_inputs<11>();
+    check_network_sorts_all_binary_inputs<16>();
+    check_network_sorts_all_binary_inputs<20>();
+}
+
+static_assert(sbo::detail::network::comparator_count(4) == 5);
+static_assert(sbo::detail::network::comparator_count(8) == 19);
+static_assert(sbo::detail::network::comparator_count(16) == 63);
+
+template<typename T, size_t N, typename Compare = std::less<>>
+void check_sort_matches_std(Compare comp = Compare()) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(-50, 50);
+    for (size_t size = 0; size <= N + 4; ++size) {
+        sbo::small_vector<T, N> vec;
+        for (size_t i = 0; i < size; ++i) {
+            if constexpr (std::is_same_v<T, std::string>)
+                vec.push_back(std::to_string(dist(rng)));
+            else
+                vec.push_back(static_cast<T>(dist(rng)));
+        }
+        std::vector<T> expected(vec.begin(), vec.end());
+        std::sort(expected.begin(), expected.end(), comp);
+        sbo::sort(vec, comp);
+        CHECK(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+    }
+}
+
+TEST_CASE("sort_matches_std_sort") {
+    check_sort_matches_std<int, 4>();
+    check_sort_matches_std<int, 16>();
+    check_sort_matches_std<uint8_t, 32>();
+    check_sort_matches_std<double, 13>();
+    check_sort_matches_std<float, 8>(std::greater<>());
+    check_sort_matches_std<int64_t, 64>();
+    check_sort_matches_std<std::string, 8>();
+    check_sort_matches_std<std::string, 16>([](const std::string& lhs, const std::string& rhs) { return lhs.size() < rhs.size() || (lhs.size() == rhs.size() && lhs < rhs); });
+}
@@ -0,0 +1,223 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#include <doctest/doctest.h>
+#include <small_vector/small_vector.h>
+#include <small_vector/thread_cache.h>
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//gcc doesn't know that the replaced operator new uses malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+//The global operator new/delete of the test binary count the heap allocations, so the tests can check that
+//operations on small_vectors which fit into the small buffer never touch the heap. The count is per thread, so threads
+//started by a test (e.g. thread_cache_is_returned_when_the_thread_exits) don't race on it.
+static thread_local size_t g_heapAllocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_heapAllocations;
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return ::operator new(size, tag); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+//heap allocations since the construction of the scope
+struct allocation_scope {
+    size_t start = g_heapAllocations;
+    size_t allocations() const noexcept { return g_heapAllocations - start; }
+};
+
+TEST_CASE("counting_hook_sees_heap_allocations") {
+    allocation_scope scope;
+    sbo::small_vector<int, 2> vec{1, 2, 3};
+    const size_t allocations = scope.allocations();
+    CHECK(allocations == 1);
+}
+
+template<typename T>
+void check_no_allocations_in_small_buffer(const T& value) {
+    using vector_t = sbo::small_vector<T, 8>;
+    const std::vector<T> source(3, value);
+    allocation_scope scope;
+    SUBCASE("construct") {
+        vector_t defaulted;
+        vector_t counted(8);
+        vector_t filled(8, value);
+        vector_t ranged(source.begin(), source.end());
+        vector_t listed{value, value, value};
+        vector_t overwritten(8, sbo::default_init);
+    }
+    SUBCASE("copy and move") {
+        vector_t vec(5, value);
+        vector_t copied(vec);
+        vector_t moved(std::move(copied));
+        vector_t assigned;
+        assigned = vec;
+        assigned = std::move(moved);
+        assigned = {value, value};
+        assigned.assign(8, value);
+        assigned.assign(source.begin(), source.end());
+    }
+    SUBCASE("swap") {
+        vector_t lhs(3, value);
+        vector_t rhs(8, value);
+        lhs.swap(rhs);
+        std::swap(lhs, rhs);
+        swap(lhs, rhs);
+    }
+    SUBCASE("insert and erase") {
+        vector_t vec;
+        vec.push_back(value);
+        vec.emplace_back(value);
+        vec.insert(vec.begin(), value);
+        vec.emplace(vec.begin() + 1, value);
+        vec.insert(vec.end(), 2, value);
+        vec.insert(vec.begin(), source.begin(), source.begin() + 2);
+        vec.erase(vec.begin());
+        vec.erase(vec.begin(), vec.begin() + 2);
+        vec.append_range(source);
+        vec.pop_back();
+        vec.clear();
+    }
+    SUBCASE("resize") {
+        vector_t vec;
+        vec.resize(8);
+        vec.resize(2);
+        vec.resize(6, value);
+        vec.resize_for_overwrite(8);
+        vec.reserve(8);
+        vec.shrink_to_fit();
+    }
+    const size_t allocations = scope.allocations();
+    CHECK(allocations == 0);
+}
+
+TEST_CASE("no_heap_allocations_while_size_fits_into_the_small_buffer") {
+    check_no_allocations_in_small_buffer<int>(42);
+    //short strings use their own small buffer
+    check_no_allocations_in_small_buffer<std::string>("short");
+}
+
+TEST_CASE("no_heap_allocations_for_small_buffer_vector_allocator") {
+    using allocator_t = sbo::small_buffer_vector_allocator<int, 8>;
+    allocation_scope scope;
+    {
+        std::vector<int, allocator_t> vec;
+        vec.reserve(8);
+        for (int i = 0; i < 8; ++i)
+            vec.push_back(i);
+        vec.erase(vec.begin() + 2);
+        vec.insert(vec.begin(), 7);
+        vec.resize(4);
+        std::vector<int, allocator_t> copied(vec);
+        copied.push_back(1);
+    }
+    size_t allocations = scope.allocations();
+    CHECK(allocations == 0);
+
+    std::vector<int, allocator_t> vec(9);
+    allocations = scope.allocations();
+    CHECK(allocations == 1);
+}
+
+TEST_CASE("thread_cache_reuses_freed_spill_blocks") {
+    using vector_t = sbo::small_vector<int, 4, sbo::thread_cache_allocator<int>>;
+    sbo::thread_cache::flush();
+    allocation_scope scope;
+    auto fill = [] {
+        vector_t vec;
+        for (int i = 0; i < 100; ++i)
+            vec.push_back(i);
+        CHECK(vec.capacity() == 128);
+    };
+    fill();
+    const size_t firstAllocations = scope.allocations();
+    CHECK(firstAllocations == 5);
+    CHECK(sbo::thread_cache::cached_bytes() == 32 + 64 + 128 + 256 + 512);
+    fill();
+    size_t allocations = scope.allocations();
+    CHECK(allocations == firstAllocations);
+
+    sbo::thread_cache::flush();
+    CHECK(sbo::thread_cache::cached_bytes() == 0);
+    fill();
+    allocations = scope.allocations();
+    CHECK(allocations == 2 * firstAllocations);
+    sbo::thread_cache::flush();
+}
+
+TEST_CASE("thread_cache_byte_limit") {
+    using vector_t = sbo::small_vector<int, 4, sbo::thread_cache_allocator<int>>;
+    sbo::thread_cache::flush();
+    sbo::thread_cache::set_byte_limit(100);
+    allocation_scope scope;
+    for (int round = 0; round < 2; ++round) {
+        vector_t vec;
+        for (int i = 0; i < 100; ++i)
+            vec.push_back(i);
+    }
+    //only the 32 and 64 byte blocks fit into the cache
+    const size_t allocations = scope.allocations();
+    CHECK(allocations == 5 + 3);
+    CHECK(sbo::thread_cache::cached_bytes() == 96);
+    sbo::thread_cache::set_byte_limit(0);
+    CHECK(sbo::thread_cache::cached_bytes() == 0);
+    sbo::thread_cache::set_byte_limit(sbo::thread_cache::default_byte_limit);
+
+    //blocks larger than max_block_size always use operator new
+    scope = allocation_scope();
+    for (int round = 0; round < 2; ++round)
+        vector_t vec(sbo::thread_cache::max_block_size);
+    CHECK(scope.allocations() == 2);
+}
+
+TEST_CASE("thread_cache_as_upstream_of_small_buffer_vector_allocator") {
+    using allocator_t = sbo::small_buffer_vector_allocator<int, 8, sbo::thread_cache_allocator<int>>;
+    sbo::thread_cache::flush();
+    allocation_scope scope;
+    for (int round = 0; round < 3; ++round) {
+        std::vector<int, allocator_t> vec;
+        vec.reserve(8);
+        for (int i = 0; i < 64; ++i)
+            vec.push_back(i);
+    }
+    const size_t allocations = scope.allocations();
+    CHECK(allocations == 3);
+    sbo::thread_cache::flush();
+}
+
+TEST_CASE("thread_cache_is_returned_when_the_thread_exits") {
+    sbo::thread_cache::flush();
+    //the block is allocated on this thread, but ends up in the cache of the other thread
+    auto vec = std::make_unique<sbo::small_vector<int, 4, sbo::thread_cache_allocator<int>>>(100);
+    size_t cachedBytes = 0;
+    std::thread([&] {
+        vec.reset();
+        cachedBytes = sbo::thread_cache::cached_bytes();
+    }).join();
+    CHECK(cachedBytes == 512);
+    CHECK(sbo::thread_cache::cached_bytes() == 0);
+}
@@ -0,0 +1,83 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+//a separate executable, SBO_SIZE_PROFILING is defined for all of its translation units (see test/CMakeLists.txt)
+#if !defined(SBO_SIZE_PROFILING)
+#  error "size_profile_tests needs SBO_SIZE_PROFILING"
+#endif
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <small_vector/small_vector.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+    struct profiled_element {
+        int value = 0;
+    };
+    using profiled_vector = sbo::small_vector<profiled_element, 4>;
+
+    const sbo::size_profile_site* find_site(const std::vector<sbo::size_profile_site>& sites, uint_least32_t line) {
+        const auto it = std::find_if(sites.begin(), sites.end(), [&](const auto& site) { return site.line == line; });
+        return it != sites.end() ? &*it : nullptr;
+    }
+}
+
+TEST_CASE("size_profile_records_the_peak_size_per_construction_site") {
+    sbo::set_size_profile_exit_report(nullptr);
+    sbo::reset_size_profile();
+    const auto firstLine = static_cast<uint_least32_t>(__LINE__ + 3);
+    for (size_t size = 0; size < 20; ++size) {
+        //the peak size is recorded even when the vector shrinks before its destruction
+        profiled_vector vec;
+        vec.resize(size);
+        vec.clear();
+    }
+    const auto secondLine = static_cast<uint_least32_t>(__LINE__ + 2);
+    {
+        profiled_vector constructed(3);
+        profiled_vector moved(std::move(constructed));
+        profiled_vector swapped;
+        swapped.swap(moved);
+    }
+
+    const auto sites = sbo::size_profile();
+    const sbo::size_profile_site* loop = find_site(sites, firstLine);
+    REQUIRE(loop != nullptr);
+    CHECK(std::string(loop->file).find("size_profile_tests.cpp") != std::string::npos);
+    CHECK(loop->elementType.find("profiled_element") != std::string_view::npos);
+    CHECK(loop->inlineCapacity == 4);
+    CHECK(loop->elementSize == sizeof(profiled_element));
+    CHECK(loop->instances() == 20);
+    CHECK(loop->percentile(0.5) == 9);
+    CHECK(loop->percentile(0.95) == 18);
+    CHECK(loop->percentile(1.) == 19);
+    CHECK(loop->spill_rate() == 0.75);
+    CHECK(loop->recommended_inline_capacity(0.95, 256) == 18);
+    //at most 32 bytes of inline elements
+    CHECK(loop->recommended_inline_capacity(0.95, 32) == 32 / sizeof(profiled_element));
+
+    //moved and swapped vectors are attributed to the site of their own constructor
+    for (uint_least32_t line = secondLine; line < secondLine + 3; ++line) {
+        const sbo::size_profile_site* site = find_site(sites, line);
+        REQUIRE(site != nullptr);
+        CHECK(site->instances() == 1);
+        CHECK(site->percentile(1.) == 3);
+    }
+}
+
+TEST_CASE("size_profile_report") {
+    sbo::set_size_profile_exit_report(nullptr);
+    sbo::reset_size_profile();
+    for (size_t size = 1; size <= 4; ++size)
+        profiled_vector vec(size);
+    std::ostringstream out;
+    sbo::write_size_profile_report(out);
+    const std::string report = out.str();
+    CHECK(report.find("size_profile_tests.cpp:") != std::string::npos);
+    CHECK(report.find("instances: 4, peak size p50: 2, p95: 4, max: 4, spilled: 0%, recommended N: 4") != std::string::npos);
+    CHECK(report.find("peak sizes: 1: 1 2-3: 2 4-7: 1") != std::string::npos);
+    sbo::reset_size_profile();
+}
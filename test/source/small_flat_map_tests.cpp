@@ -0,0 +1,125 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#include <doctest/doctest.h>
+#include <small_vector/small_flat_map.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+TEST_CASE("count_less_matches_scalar_loop") {
+    const int8_t int8s[] = {-128, -5, 0, 3, 3, 7, 20, 100, 127, -1, 5, 6, 8, 9, 10, 11, 12, 13};
+    CHECK(sbo::detail::simd::count_less(int8s, std::size(int8s), int8_t(4)) == 6);
+    const uint8_t uint8s[] = {0, 1, 2, 100, 128, 129, 200, 255, 254, 3, 4, 5, 6, 7, 8, 9, 250};
+    CHECK(sbo::detail::simd::count_less(uint8s, std::size(uint8s), uint8_t(130)) == 13);
+    const uint32_t uint32s[] = {0, 1, 0x80000000u, 0xFFFFFFFFu, 5, 0x7FFFFFFFu};
+    CHECK(sbo::detail::simd::count_less(uint32s, std::size(uint32s), 0x80000001u) == 5);
+    const float floats[] = {-1.5f, 0.f, 2.5f, 3.f, 10.f, -20.f};
+    CHECK(sbo::detail::simd::count_less(floats, std::size(floats), 2.5f) == 3);
+    const double doubles[] = {-1.5, 0., 2.5};
+    CHECK(sbo::detail::simd::count_less(doubles, std::size(doubles), 1.) == 2);
+}
+
+TEST_CASE("small_flat_set") {
+    sbo::small_flat_set<int, 8> set{5, 1, 3, 3, 9};
+    CHECK(set.size() == 4);
+    CHECK(std::is_sorted(set.begin(), set.end()));
+    CHECK(set.contains(3));
+    CHECK_FALSE(set.contains(4));
+    CHECK(set.insert(4).second);
+    CHECK_FALSE(set.insert(4).second);
+    CHECK(*set.lower_bound(6) == 9);
+    CHECK(set.upper_bound(9) == set.end());
+    CHECK(set.erase(1) == 1);
+    CHECK(set.erase(1) == 0);
+    CHECK(set == sbo::small_flat_set<int, 8>{3, 4, 5, 9});
+
+    sbo::small_flat_set<std::string, 2> strings{"b", "a", "c"};
+    CHECK(strings.find("c") == strings.begin() + 2);
+    CHECK(strings.find("d") == strings.end());
+    CHECK(strings.keys() == sbo::small_vector<std::string, 2>{"a", "b", "c"});
+
+    sbo::small_flat_set<int, 4, std::greater<int>> descending{1, 5, 3};
+    CHECK(descending.keys() == sbo::small_vector<int, 4>{5, 3, 1});
+    CHECK(descending.contains(5));
+}
+
+template<typename SetT>
+void check_against_std_set() {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(-50, 50);
+    SetT set;
+    std::set<typename SetT::key_type> expected;
+    for (int i = 0; i < 500; ++i) {
+        const auto key = static_cast<typename SetT::key_type>(distribution(generator));
+        if (i % 3 == 2) {
+            CHECK(set.erase(key) == expected.erase(key));
+        } else {
+            CHECK(set.insert(key).second == expected.insert(key).second);
+        }
+        CHECK(set.contains(key) == (expected.count(key) == 1));
+        REQUIRE(set.size() == expected.size());
+    }
+    CHECK(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+}
+
+TEST_CASE("small_flat_set_random_operations") {
+    //the linear scan is used up to N keys, the binary search for the larger sets
+    check_against_std_set<sbo::small_flat_set<int, 16>>();
+    check_against_std_set<sbo::small_flat_set<int8_t, 64>>();
+    check_against_std_set<sbo::small_flat_set<uint16_t, 8>>();
+    check_against_std_set<sbo::small_flat_set<double, 8>>();
+}
+
+TEST_CASE("small_flat_map") {
+    sbo::small_flat_map<int, std::string, 4> map{{3, "c"}, {1, "a"}, {2, "b"}, {1, "x"}};
+    REQUIRE(map.size() == 3);
+    CHECK(map.keys() == sbo::small_vector<int, 4>{1, 2, 3});
+    CHECK(map.at(1) == "a");
+    CHECK(map.find(2)->second == "b");
+    CHECK(map.find(4) == map.end());
+    CHECK_THROWS_AS(map.at(4), std::out_of_range);
+
+    map[4] = "d";
+    map[2] += "b";
+    CHECK(map.at(2) == "bb");
+    CHECK_FALSE(map.try_emplace(4, "e").second);
+    CHECK_FALSE(map.insert_or_assign(4, "e").second);
+    CHECK(map[4] == "e");
+    const auto emplaced = map.emplace(0, "z");
+    CHECK(emplaced.first == map.begin());
+
+    std::string concatenated;
+    for (const auto& [key, value] : map)
+        concatenated += std::to_string(key) + value;
+    CHECK(concatenated == "0z1a2bb3c4e");
+    for (auto [key, value] : map)
+        value = "v";
+    CHECK(map.values() == sbo::small_vector<std::string, 4>(5, "v"));
+
+    CHECK(map.erase(2) == 1);
+    auto it = map.erase(map.begin());
+    CHECK(it->first == 1);
+    CHECK(map.keys() == sbo::small_vector<int, 4>{1, 3, 4});
+    CHECK(std::prev(map.cend())->first == 4);
+    CHECK(map.rbegin()->first == 4);
+}
+
+TEST_CASE("small_flat_map_random_operations") {
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> distribution(0, 40);
+    sbo::small_flat_map<unsigned, int, 8> map;
+    std::map<unsigned, int> expected;
+    for (int i = 0; i < 400; ++i) {
+        const auto key = static_cast<unsigned>(distribution(generator));
+        if (i % 4 == 3)
+            CHECK(map.erase(key) == expected.erase(key));
+        else
+            map[key] = expected[key] = i;
+        REQUIRE(map.size() == expected.size());
+    }
+    for (const auto& [key, value] : expected)
+        CHECK(map.at(key) == value);
+}
@@ -9,6 +9,7 @@
 #include <numeric>
 #include <vector>
 #include <memory>
+#include <string>
 
 #include <chrono>
 #include <cstring>
@@ -19,6 +20,16 @@ struct ThrowMoveT{
 
 static_assert(std::is_nothrow_move_constructible_v<sbo::small_vector<int, 100>>);
 static_assert(!std::is_nothrow_move_constructible_v<sbo::small_vector<ThrowMoveT, 100>>);
+static_assert(std::is_nothrow_move_assignable_v<sbo::small_vector<std::string, 8>>);
+//elements in the small buffers are move assigned
+struct ThrowMoveAssignT{
+    ThrowMoveAssignT(ThrowMoveAssignT&&) noexcept {}
+    ThrowMoveAssignT& operator=(ThrowMoveAssignT&&) noexcept(false) { return *this; }
+};
+static_assert(!std::is_nothrow_move_assignable_v<sbo::small_vector<ThrowMoveAssignT, 8>>);
+//the small buffer of a vector with a different N might not fit, which allocates
+static_assert(!std::is_nothrow_assignable_v<sbo::small_vector<int, 2>&, sbo::small_vector_impl<int>&&>);
+static_assert(!std::is_nothrow_assignable_v<sbo::small_vector_impl<int>&, sbo::small_vector_impl<int>&&>);
 
 
 TEST_CASE("test_for_crash_access_used_moved_from_trivial_copyable_type") {
@@ -50,6 +61,62 @@ TEST_CASE("test_for_crash_access_used_moved_from_move_only_type") {
     for (unsigned i = 0; i < 50; ++i)
         CHECK(myVector2[i] == nullptr);
 }
+struct RelocatableT {
+    static inline int moves = 0;
+    static inline int destructions = 0;
+    int value = 0;
+    RelocatableT(int v) : value(v) {}
+    RelocatableT(RelocatableT&& other) noexcept : value(other.value) { ++moves; }
+    RelocatableT& operator=(RelocatableT&& other) noexcept { value = other.value; ++moves; return *this; }
+    ~RelocatableT() { ++destructions; }
+};
+template<>
+struct sbo::is_trivially_relocatable<RelocatableT> : std::true_type {};
+
+TEST_CASE("move_small_buffer_relocates_bytewise") {
+    sbo::small_vector<RelocatableT, 4> vec;
+    vec.emplace_back(1);
+    vec.emplace_back(2);
+    RelocatableT::moves = RelocatableT::destructions = 0;
+
+    sbo::small_vector<RelocatableT, 4> moved(std::move(vec));
+    CHECK(vec.empty());
+    REQUIRE(moved.size() == 2);
+    CHECK(moved[1].value == 2);
+
+    sbo::small_vector<RelocatableT, 4> assigned;
+    assigned.emplace_back(3);
+    assigned = std::move(moved);
+    CHECK(moved.empty());
+    REQUIRE(assigned.size() == 2);
+    CHECK(assigned[0].value == 1);
+    CHECK(RelocatableT::moves == 0);
+    //only the element which was overwritten by the move assignment is destroyed
+    CHECK(RelocatableT::destructions == 1);
+
+    //reallocation relocates as well
+    RelocatableT::destructions = 0;
+    assigned.emplace_back(4);
+    assigned.emplace_back(5);
+    assigned.emplace_back(6);
+    CHECK(RelocatableT::moves == 0);
+    CHECK(RelocatableT::destructions == 0);
+    CHECK(assigned[4].value == 6);
+}
+
+TEST_CASE("move_nested_small_vectors") {
+    sbo::small_vector<sbo::small_vector<int, 4>, 2> outer;
+    outer.push_back({1, 2});
+    outer.push_back({3, 4, 5, 6, 7});
+    outer.push_back({8});
+    auto moved = std::move(outer);
+    CHECK(outer.empty());
+    REQUIRE(moved.size() == 3);
+    CHECK(moved[0] == sbo::small_vector<int, 4>{1, 2});
+    CHECK(moved[1].size() == 5);
+    CHECK(moved[2].front() == 8);
+}
+
 TEST_CASE("swap_test_small") {
     sbo::small_vector<int, 10> ints1, ints2;
     ints1.push_back(1);
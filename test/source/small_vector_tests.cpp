@@ -0,0 +1,754 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+#include <doctest/doctest.h>
+#include <small_vector/small_vector.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <scoped_allocator>
+#include <sstream>
+#include <stdexcept>
+#include <iterator>
+#include <string>
+#include <vector>
+
+TEST_CASE("default_construct_uses_small_buffer") {
+    sbo::small_vector<std::string, 4> vec;
+    CHECK(vec.empty());
+    CHECK(vec.capacity() == 4);
+    CHECK(reinterpret_cast<const std::byte*>(vec.data()) >= reinterpret_cast<const std::byte*>(&vec));
+    CHECK(reinterpret_cast<const std::byte*>(vec.data()) < reinterpret_cast<const std::byte*>(&vec + 1));
+}
+
+TEST_CASE("grow_beyond_small_buffer") {
+    sbo::small_vector<std::string, 4> vec;
+    for (int i = 0; i < 20; ++i)
+        vec.push_back(std::to_string(i));
+    CHECK(vec.size() == 20);
+    CHECK(vec.capacity() >= 20);
+    for (int i = 0; i < 20; ++i)
+        CHECK(vec[static_cast<size_t>(i)] == std::to_string(i));
+}
+
+TEST_CASE("push_back_of_own_element_during_reallocation") {
+    sbo::small_vector<std::string, 2> vec{"a", "b"};
+    vec.push_back(vec[0]);
+    vec.insert(vec.begin(), vec[2]);
+    vec.insert(vec.begin() + 1, 2, vec[0]);
+    CHECK(vec == sbo::small_vector<std::string, 2>{"a", "a", "a", "a", "b", "a"});
+}
+
+TEST_CASE("insert_ranges") {
+    sbo::small_vector<int, 8> vec{1, 2, 3};
+    const int values[] = {7, 8};
+    SUBCASE("forward iterators in place") {
+        vec.insert(vec.begin() + 1, std::begin(values), std::end(values));
+        CHECK(vec == sbo::small_vector<int, 8>{1, 7, 8, 2, 3});
+    }
+    SUBCASE("forward iterators with reallocation") {
+        const std::list<int> many(10, 5);
+        vec.insert(vec.begin() + 1, many.begin(), many.end());
+        CHECK(vec.size() == 13);
+        CHECK(vec.front() == 1);
+        CHECK(vec[1] == 5);
+        CHECK(vec.back() == 3);
+    }
+    SUBCASE("input iterators") {
+        std::istringstream stream("4 5 6 7 8 9");
+        vec.insert(vec.begin(), std::istream_iterator<int>(stream), std::istream_iterator<int>());
+        CHECK(vec == sbo::small_vector<int, 8>{4, 5, 6, 7, 8, 9, 1, 2, 3});
+    }
+    SUBCASE("count and value") {
+        vec.insert(vec.end() - 1, 2, 0);
+        CHECK(vec == sbo::small_vector<int, 8>{1, 2, 0, 0, 3});
+    }
+}
+
+TEST_CASE("erase_and_resize") {
+    sbo::small_vector<std::unique_ptr<int>, 4> vec(6);
+    for (size_t i = 0; i < vec.size(); ++i)
+        vec[i] = std::make_unique<int>(static_cast<int>(i));
+    vec.erase(vec.begin() + 1, vec.begin() + 3);
+    REQUIRE(vec.size() == 4);
+    CHECK(*vec[1] == 3);
+    vec.erase(vec.begin());
+    CHECK(*vec.front() == 3);
+    vec.resize(1);
+    CHECK(vec.size() == 1);
+    vec.resize(3);
+    CHECK(vec.back() == nullptr);
+}
+
+TEST_CASE("copy_and_move_heap_storage") {
+    sbo::small_vector<std::string, 2> vec{"a", "b", "c"};
+    sbo::small_vector<std::string, 2> copy(vec);
+    CHECK(copy == vec);
+    const auto* heapData = vec.data();
+    sbo::small_vector<std::string, 2> moved(std::move(vec));
+    CHECK(moved.data() == heapData);
+    CHECK(vec.empty());
+    CHECK(vec.capacity() == 2);
+    vec = copy;
+    CHECK(vec == copy);
+}
+
+TEST_CASE("at_throws_out_of_range") {
+    sbo::small_vector<int, 4> vec{1};
+    CHECK(vec.at(0) == 1);
+    CHECK_THROWS_AS(vec.at(1), std::out_of_range);
+}
+
+struct allocation_counter {
+    int allocations = 0;
+    int deallocations = 0;
+};
+
+//stateful upstream allocator, two allocators are equal when they share the same counter
+template<typename T>
+struct counting_allocator {
+    using value_type = T;
+    allocation_counter* counter;
+
+    explicit counting_allocator(allocation_counter& c) noexcept : counter(&c) {}
+    template<typename U>
+    counting_allocator(const counting_allocator<U>& other) noexcept : counter(other.counter) {}
+    T* allocate(size_t n) {
+        ++counter->allocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        ++counter->deallocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+    friend bool operator==(const counting_allocator& lhs, const counting_allocator& rhs) { return lhs.counter == rhs.counter; }
+    friend bool operator!=(const counting_allocator& lhs, const counting_allocator& rhs) { return lhs.counter != rhs.counter; }
+};
+
+static_assert(sizeof(sbo::small_vector<int, 8>) == sizeof(int*) + 2 * sizeof(size_t) + 8 * sizeof(int), 
+    "a stateless allocator doesn't take any space");
+static_assert(sizeof(sbo::small_vector<int, 8, counting_allocator<int>>) == sizeof(sbo::small_vector<int, 8>) + sizeof(void*));
+
+//sizeof for common instantiations: pointer + size + capacity + small buffer, rounded up to the alignment
+constexpr size_t round_up(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+template<typename SizeT, typename T, size_t N>
+constexpr size_t expected_size = round_up(round_up(sizeof(T*) + 2 * sizeof(SizeT), alignof(T)) + N * sizeof(T), 
+                                          std::max(alignof(T*), alignof(T)));
+
+static_assert(sizeof(sbo::small_vector<int, 8>) == expected_size<size_t, int, 8>);
+static_assert(sizeof(sbo::small_vector<char, 16>) == expected_size<size_t, char, 16>);
+static_assert(sizeof(sbo::small_vector<double, 4>) == expected_size<size_t, double, 4>);
+static_assert(sizeof(sbo::compact_small_vector<int, 8>) == expected_size<uint32_t, int, 8>);
+static_assert(sizeof(sbo::compact_small_vector<char, 16>) == expected_size<uint32_t, char, 16>);
+static_assert(sizeof(sbo::compact_small_vector<double, 4>) == expected_size<uint32_t, double, 4>);
+static_assert(sizeof(sbo::compact_small_vector<char, 20, uint16_t>) == expected_size<uint16_t, char, 20>);
+static_assert(sizeof(sbo::compact_small_vector<int, 8>) + 8 == sizeof(sbo::small_vector<int, 8>) || sizeof(void*) == 4);
+static_assert(sizeof(sbo::compact_small_vector<char, 4, uint16_t>) == 2 * sizeof(void*) || sizeof(void*) == 4);
+
+TEST_CASE("compact_small_vector_limits_max_size") {
+    sbo::compact_small_vector<char, 8, uint16_t> vec;
+    CHECK(vec.max_size() == 65535);
+    vec.resize(1000, 'x');
+    CHECK(vec.size() == 1000);
+    CHECK(vec.capacity() >= 1000);
+    vec.resize(65535);
+    CHECK(vec.capacity() == 65535);
+    CHECK_THROWS_AS(vec.push_back('y'), std::length_error);
+    CHECK(vec.size() == 65535);
+    CHECK(vec[999] == 'x');
+}
+
+//small_vector_bytes takes whole cache lines, N is the largest capacity that fits
+static_assert(sizeof(sbo::small_vector_bytes<int>) == sbo::cache_line_size);
+static_assert(alignof(sbo::small_vector_bytes<int>) == sbo::cache_line_size);
+static_assert(sizeof(sbo::small_vector_bytes<char, 2 * sbo::cache_line_size>) == 2 * sbo::cache_line_size);
+static_assert(sizeof(sbo::small_vector_bytes<int, 64>::vector_type) <= 64);
+static_assert(sizeof(sbo::small_vector<int, sbo::small_vector_bytes<int, 64>::static_capacity + 1>) > 64);
+static_assert(sbo::small_vector_bytes<int, 64>::static_capacity == (64 - sizeof(int*) - 2 * sizeof(size_t)) / sizeof(int));
+static_assert(sbo::small_vector_bytes<int, 64, std::allocator<int>, uint32_t>::static_capacity
+              == (64 - sizeof(int*) - 2 * sizeof(uint32_t)) / sizeof(int));
+static_assert(sbo::small_vector_bytes<std::array<char, 40>, 64>::static_capacity == 1);
+
+TEST_CASE("small_vector_bytes") {
+    using vector_t = sbo::small_vector_bytes<int, 64>;
+    constexpr int n = static_cast<int>(vector_t::static_capacity);
+    std::array<vector_t, 4> vectors;
+    for (auto& vec : vectors)
+        CHECK(reinterpret_cast<uintptr_t>(&vec) % sbo::cache_line_size == 0);
+
+    vector_t vec{1, 2, 3};
+    CHECK(vec.capacity() == vector_t::static_capacity);
+    CHECK(vec.inline_capacity() == vector_t::static_capacity);
+    for (int i = 3; i < n + 1; ++i)
+        vec.push_back(i + 1);
+    CHECK(vec.capacity() > vector_t::static_capacity);
+    CHECK(vec.inline_capacity() == vector_t::static_capacity);
+    CHECK(vec.back() == n + 1);
+    vector_t copy(vec);
+    CHECK(copy == vec);
+    vectors[1] = std::move(copy);
+    CHECK(vectors[1] == vec);
+    vec = {7, 8};
+    CHECK(vec.size() == 2);
+    swap(vec, vectors[1]);
+    CHECK(vec.size() == static_cast<size_t>(n + 1));
+    CHECK(vectors[1][1] == 8);
+}
+
+TEST_CASE("upstream_allocator_is_used_for_spills") {
+    allocation_counter counter;
+    using vector_t = sbo::small_vector<int, 4, counting_allocator<int>>;
+    {
+        vector_t vec{counting_allocator<int>(counter)};
+        for (int i = 0; i < 4; ++i)
+            vec.push_back(i);
+        CHECK(counter.allocations == 0);
+        vec.push_back(4);
+        CHECK(counter.allocations == 1);
+
+        vector_t copy(vec);
+        CHECK(copy.get_allocator() == vec.get_allocator());
+        CHECK(counter.allocations == 2);
+        vector_t moved(std::move(copy));
+        CHECK(counter.allocations == 2);
+    }
+    CHECK(counter.deallocations == 2);
+}
+
+TEST_CASE("move_assign_with_unequal_upstream_allocators") {
+    allocation_counter counter1, counter2;
+    using vector_t = sbo::small_vector<int, 2, counting_allocator<int>>;
+    vector_t vec1({1, 2, 3}, counting_allocator<int>(counter1));
+    vector_t vec2{counting_allocator<int>(counter2)};
+    const int* heapData = vec1.data();
+    vec2 = std::move(vec1);
+    //the allocator doesn't propagate, so the heap memory of vec1 can't be taken over
+    CHECK(vec2.data() != heapData);
+    CHECK(counter2.allocations == 1);
+    CHECK(vec2 == vector_t({1, 2, 3}, counting_allocator<int>(counter2)));
+    CHECK(vec2.get_allocator().counter == &counter2);
+}
+
+TEST_CASE("small_buffer_vector_allocator_with_upstream") {
+    allocation_counter counter;
+    using allocator_t = sbo::small_buffer_vector_allocator<int, 4, counting_allocator<int>>;
+    std::vector<int, allocator_t> vec{allocator_t(counting_allocator<int>(counter))};
+    vec.reserve(4);
+    vec.assign({1, 2, 3, 4});
+    CHECK(counter.allocations == 0);
+    vec.push_back(5);
+    CHECK(counter.allocations == 1);
+    CHECK(vec.back() == 5);
+}
+
+#if defined(__cpp_lib_memory_resource)
+TEST_CASE("pmr_small_vector_spills_into_memory_resource") {
+    std::byte arena[1024];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+    sbo::pmr::small_vector<int, 4> vec(&resource);
+    for (int i = 0; i < 4; ++i)
+        vec.push_back(i);
+    CHECK(vec.capacity() == 4);
+    for (int i = 4; i < 20; ++i)
+        vec.push_back(i);
+    CHECK(reinterpret_cast<std::byte*>(vec.data()) >= std::begin(arena));
+    CHECK(reinterpret_cast<std::byte*>(vec.data()) < std::end(arena));
+    CHECK(vec.get_allocator().resource() == &resource);
+}
+
+TEST_CASE("pmr_small_vector_propagates_resource_to_nested_vectors") {
+    std::byte arena[1024];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+    sbo::pmr::small_vector<sbo::pmr::small_vector<int, 2>, 2> outer(&resource);
+    outer.emplace_back();
+    outer.emplace_back(3, 7);
+    outer.push_back(outer.front());
+    for (auto& inner : outer) {
+        CHECK(inner.get_allocator().resource() == &resource);
+        inner.assign({1, 2, 3, 4});
+        CHECK(reinterpret_cast<std::byte*>(inner.data()) >= std::begin(arena));
+        CHECK(reinterpret_cast<std::byte*>(inner.data()) < std::end(arena));
+    }
+}
+#endif
+
+TEST_CASE("scoped_allocator_adaptor_propagates_to_nested_vectors") {
+    allocation_counter counter;
+    using inner_t = sbo::small_vector<int, 2, counting_allocator<int>>;
+    using outer_t = sbo::small_vector<inner_t, 2, std::scoped_allocator_adaptor<counting_allocator<inner_t>>>;
+    outer_t outer{std::scoped_allocator_adaptor<counting_allocator<inner_t>>(counter)};
+    outer.emplace_back();
+    outer.back().assign({1, 2, 3});
+    CHECK(outer.back().get_allocator().counter == &counter);
+    CHECK(counter.allocations == 1);
+}
+
+template<typename VectorT>
+bool uses_small_buffer(const VectorT& vec) {
+    const auto* data = reinterpret_cast<const std::byte*>(vec.data());
+    return data >= reinterpret_cast<const std::byte*>(&vec) && data < reinterpret_cast<const std::byte*>(&vec + 1);
+}
+
+TEST_CASE("shrink_to_fit_moves_back_into_small_buffer") {
+    allocation_counter counter;
+    sbo::small_vector<std::string, 4, counting_allocator<std::string>> vec({"a", "b", "c", "d", "e", "f"}, counting_allocator<std::string>(counter));
+    REQUIRE_FALSE(uses_small_buffer(vec));
+    vec.erase(vec.begin() + 1, vec.begin() + 4);
+    vec.shrink_to_fit();
+    CHECK(uses_small_buffer(vec));
+    CHECK(vec.capacity() == 4);
+    CHECK(counter.deallocations == counter.allocations);
+    CHECK(vec == decltype(vec)({"a", "e", "f"}, counting_allocator<std::string>(counter)));
+
+    vec.assign(10, "x");
+    vec.pop_back();
+    vec.shrink_to_fit();
+    CHECK(vec.capacity() == 9);
+    CHECK(vec.back() == "x");
+}
+
+TEST_CASE("shrink_policy_moves_back_automatically") {
+    sbo::small_vector<std::unique_ptr<int>, 4, std::allocator<std::unique_ptr<int>>, size_t, sbo::shrink_below_percent<50>> vec;
+    for (int i = 0; i < 8; ++i)
+        vec.push_back(std::make_unique<int>(i));
+    vec.erase(vec.begin(), vec.begin() + 4);
+    //4 elements would fit, but the policy waits until only half of the small buffer is used
+    CHECK_FALSE(uses_small_buffer(vec));
+    vec.pop_back();
+    vec.resize(2);
+    CHECK(uses_small_buffer(vec));
+    CHECK(*vec[0] == 4);
+    CHECK(*vec[1] == 5);
+
+    sbo::small_vector<int, 4> neverShrinks(8);
+    neverShrinks.clear();
+    CHECK_FALSE(uses_small_buffer(neverShrinks));
+}
+
+static_assert(sbo::grow_double::next_capacity(8, 9, 4) == 16);
+static_assert(sbo::grow_one_and_a_half::next_capacity(9, 10, 4) == 13);
+static_assert(sbo::grow_by<16>::next_capacity(8, 9, 4) == 24);
+static_assert(sbo::grow_by<16>::next_capacity(8, 100, 4) == 100);
+static_assert(sbo::grow_to_size_class::round_to_size_class(129) == 160);
+static_assert(sbo::grow_to_size_class::round_to_size_class(257) == 320);
+static_assert(sbo::grow_to_size_class::next_capacity(8, 9, 12) == 16);
+static_assert(sbo::grow_to_size_class::next_capacity(40, 41, 4) == 80);
+static_assert(sbo::grow_to_size_class::next_capacity(50, 51, 4) == 112);
+static_assert(sbo::grow_to_page_multiple<4096>::next_capacity(8, 9, 4) == 1024);
+
+template<typename GrowthPolicy>
+using growth_vector = sbo::small_vector<int, 4, std::allocator<int>, size_t, sbo::never_shrink, GrowthPolicy>;
+
+TEST_CASE("growth_policies") {
+    growth_vector<sbo::grow_one_and_a_half> oneAndAHalf;
+    oneAndAHalf.resize(5);
+    CHECK(oneAndAHalf.capacity() == 6);
+    oneAndAHalf.resize(7);
+    CHECK(oneAndAHalf.capacity() == 9);
+
+    growth_vector<sbo::grow_by<10>> linear;
+    linear.resize(5);
+    CHECK(linear.capacity() == 14);
+    linear.insert(linear.end(), 20, 1);
+    CHECK(linear.capacity() == 25);
+
+    growth_vector<sbo::grow_to_page_multiple<>> pages;
+    pages.assign({1, 2, 3, 4});
+    pages.push_back(5);
+    CHECK(pages.capacity() == 1024);
+    CHECK(pages.back() == 5);
+}
+
+TEST_CASE("malloc_allocator_grows_with_realloc") {
+    sbo::small_vector<int, 4, sbo::malloc_allocator<int>> vec;
+    for (int i = 0; i < 1000; ++i)
+        vec.push_back(i);
+    //the argument references an element, which is invalidated when the heap block is reallocated
+    while (vec.size() != vec.capacity())
+        vec.push_back(0);
+    vec.push_back(vec[1]);
+    CHECK(vec.back() == 1);
+    vec.resize(5000);
+    CHECK(vec[4999] == 0);
+    vec.reserve(10000);
+    CHECK(vec.capacity() >= 10000);
+    vec.resize(2000);
+    vec.shrink_to_fit();
+    //malloc can return a bit more than requested, which is kept as capacity
+    CHECK(vec.capacity() >= 2000);
+    CHECK(vec.capacity() < 2100);
+    for (int i = 0; i < 1000; ++i)
+        CHECK(vec[static_cast<size_t>(i)] == i);
+    vec.resize(3);
+    vec.shrink_to_fit();
+    CHECK(uses_small_buffer(vec));
+    CHECK(vec[2] == 2);
+}
+
+//reports a few more elements than requested, like malloc does for its size classes
+template<typename T>
+struct slack_allocator : std::allocator<T> {
+    using value_type = T;
+    template<class U>
+    struct rebind { using other = slack_allocator<U>; };
+    slack_allocator() = default;
+    template<class U>
+    slack_allocator(const slack_allocator<U>&) noexcept {}
+    sbo::allocation_result<T*> allocate_at_least(size_t n) { return {std::allocator<T>::allocate(n + 3), n + 3}; }
+};
+
+TEST_CASE("allocate_at_least_slack_is_used_as_capacity") {
+    sbo::small_vector<int, 4, slack_allocator<int>> vec;
+    vec.resize(5);
+    CHECK(vec.capacity() == 11);
+    vec.insert(vec.end(), {1, 2, 3, 4, 5, 6});
+    CHECK(vec.capacity() == 11);
+    vec.push_back(7);
+    CHECK(vec.capacity() == 25);
+    vec.assign(30, 1);
+    CHECK(vec.capacity() == 33);
+    vec.resize(20);
+    vec.shrink_to_fit();
+    CHECK(vec.capacity() == 23);
+
+    sbo::small_buffer_vector_allocator<int, 8, slack_allocator<int>> alloc;
+    const auto small = alloc.allocate_at_least(3);
+    CHECK(small.count == 8);
+    alloc.deallocate(small.ptr, small.count);
+    const auto heap = alloc.allocate_at_least(9);
+    CHECK(heap.count == 12);
+    alloc.deallocate(heap.ptr, heap.count);
+}
+
+#if defined(__GLIBC__)
+TEST_CASE("malloc_allocator_reports_usable_size") {
+    sbo::small_vector<char, 4, sbo::malloc_allocator<char>> vec(5, 'a');
+    CHECK(vec.capacity() == malloc_usable_size(vec.data()));
+    vec.resize(vec.capacity() + 1);
+    CHECK(vec.capacity() == malloc_usable_size(vec.data()));
+}
+#endif
+
+TEST_CASE("default_init_and_resize_for_overwrite") {
+    sbo::small_vector<int, 4> vec(3, sbo::default_init);
+    CHECK(vec.size() == 3);
+    CHECK(uses_small_buffer(vec));
+    std::iota(vec.begin(), vec.end(), 0);
+    vec.resize_for_overwrite(10);
+    REQUIRE(vec.size() == 10);
+    std::iota(vec.begin() + 3, vec.end(), 3);
+    for (int i = 0; i < 10; ++i)
+        CHECK(vec[static_cast<size_t>(i)] == i);
+    vec.resize_for_overwrite(2);
+    CHECK(vec == sbo::small_vector<int, 4>{0, 1});
+
+    //non trivial types are still default constructed
+    sbo::small_vector<std::string, 2> strings(5, sbo::default_init);
+    CHECK(strings == sbo::small_vector<std::string, 2>(5));
+}
+
+TEST_CASE("append_and_insert_range") {
+    allocation_counter counter;
+    using vector_t = sbo::small_vector<int, 4, counting_allocator<int>>;
+    vector_t vec{counting_allocator<int>(counter)};
+    const std::vector<int> batch{1, 2, 3};
+    vec.append_range(batch);
+    CHECK(counter.allocations == 0);
+    //crossing N grows exactly once
+    const std::list<int> list{4, 5, 6, 7, 8, 9};
+    vec.append_range(list);
+    CHECK(counter.allocations == 1);
+    const int values[] = {10, 11};
+    vec.append(values, 2);
+    vec.insert_range(vec.begin(), std::array<int, 2>{-1, 0});
+    CHECK(vec == vector_t({-1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, counting_allocator<int>(counter)));
+
+    //the appended elements might be part of the vector itself
+    sbo::small_vector<std::string, 2> strings{"a", "b"};
+    strings.append(strings.data(), strings.size());
+    strings.append_range(strings);
+    CHECK(strings == sbo::small_vector<std::string, 2>{"a", "b", "a", "b", "a", "b", "a", "b"});
+    std::istringstream stream("c d");
+    strings.insert_range(strings.begin() + 1, std::vector<std::string>(std::istream_iterator<std::string>(stream), {}));
+    CHECK(strings[1] == "c");
+    CHECK(strings[2] == "d");
+    CHECK(strings.size() == 10);
+}
+
+TEST_CASE("construct_and_assign_allocate_at_most_once") {
+    using vector_t = sbo::small_vector<std::string, 4, counting_allocator<std::string>>;
+    for (const size_t count : {size_t(3), size_t(10)}) {
+        const size_t expected = count > 4 ? 1 : 0;
+        allocation_counter counter;
+        const counting_allocator<std::string> alloc(counter);
+        auto checkAllocations = [&](const vector_t& vec) {
+            CHECK(vec.size() == count);
+            CHECK(vec.capacity() == std::max<size_t>(count, 4));
+            CHECK(static_cast<size_t>(std::exchange(counter.allocations, 0)) == expected);
+        };
+        const std::vector<std::string> source(count, "value");
+        const vector_t other(source.begin(), source.end(), alloc);
+        checkAllocations(other);
+        checkAllocations(vector_t(count, alloc));
+        checkAllocations(vector_t(count, "value", alloc));
+        checkAllocations(vector_t(count, sbo::default_init, alloc));
+        const std::list<std::string> list(count);
+        checkAllocations(vector_t(list.begin(), list.end(), alloc));
+        checkAllocations(vector_t(other));
+        checkAllocations(vector_t(other, alloc));
+        if (count == 3)
+            checkAllocations(vector_t({"a", "b", "c"}, alloc));
+
+        vector_t assigned(alloc);
+        assigned.assign(count, "value");
+        checkAllocations(assigned);
+        vector_t assignedRange(alloc);
+        assignedRange.assign(source.begin(), source.end());
+        checkAllocations(assignedRange);
+        vector_t copyAssigned(alloc);
+        copyAssigned = other;
+        checkAllocations(copyAssigned);
+        allocation_counter otherCounter;
+        vector_t moveAssigned{counting_allocator<std::string>(otherCounter)};
+        moveAssigned = vector_t(other);
+        CHECK(static_cast<size_t>(otherCounter.allocations) == expected);
+    }
+}
+
+TEST_CASE("swap_small_and_heap_buffers") {
+    using vector_t = sbo::small_vector<std::string, 4>;
+    const vector_t small1{"a", "b", "c"}, small2{"d"}, heap1{"e", "f", "g", "h", "i"}, heap2(6, "j");
+    SUBCASE("small with small") {
+        vector_t lhs(small1), rhs(small2);
+        swap(lhs, rhs);
+        CHECK(lhs == small2);
+        CHECK(rhs == small1);
+        CHECK(uses_small_buffer(lhs));
+        CHECK(uses_small_buffer(rhs));
+    }
+    SUBCASE("small with heap") {
+        vector_t lhs(small1), rhs(heap1);
+        const std::string* heapData = rhs.data();
+        lhs.swap(rhs);
+        CHECK(lhs == heap1);
+        CHECK(lhs.data() == heapData);
+        CHECK(rhs == small1);
+        CHECK(uses_small_buffer(rhs));
+        rhs.swap(lhs);
+        CHECK(rhs.data() == heapData);
+        CHECK(lhs == small1);
+    }
+    SUBCASE("heap with heap") {
+        vector_t lhs(heap1), rhs(heap2);
+        const std::string* lhsData = lhs.data();
+        const std::string* rhsData = rhs.data();
+        swap(lhs, rhs);
+        CHECK(lhs.data() == rhsData);
+        CHECK(rhs.data() == lhsData);
+        CHECK(lhs == heap2);
+        CHECK(rhs == heap1);
+    }
+
+    sbo::small_vector<int, 4> ints1{1, 2, 3}, ints2{4}, ints3(5, 6);
+    swap(ints1, ints2);
+    CHECK(ints1 == sbo::small_vector<int, 4>{4});
+    CHECK(ints2 == sbo::small_vector<int, 4>{1, 2, 3});
+    swap(ints2, ints3);
+    CHECK(ints2 == sbo::small_vector<int, 4>(5, 6));
+    CHECK(ints3 == sbo::small_vector<int, 4>{1, 2, 3});
+}
+
+TEST_CASE("swap_with_unequal_allocators") {
+    allocation_counter counter1, counter2;
+    using vector_t = sbo::small_vector<int, 2, counting_allocator<int>>;
+    vector_t vec1({1, 2, 3}, counting_allocator<int>(counter1));
+    vector_t vec2({4}, counting_allocator<int>(counter2));
+    swap(vec1, vec2);
+    //the allocators don't propagate, so the elements are moved between the heap blocks of the allocators
+    CHECK(vec1.get_allocator().counter == &counter1);
+    CHECK(vec2.get_allocator().counter == &counter2);
+    CHECK(vec1 == vector_t({4}, counting_allocator<int>(counter1)));
+    CHECK(vec2 == vector_t({1, 2, 3}, counting_allocator<int>(counter2)));
+}
+
+//takes small_vectors with any N
+static void append_and_erase_front(sbo::small_vector_impl<std::string>& vec, int count) {
+    for (int i = 0; i < count; ++i)
+        vec.push_back(std::to_string(i));
+    vec.insert(vec.begin(), "first");
+    vec.erase(vec.begin() + 1);
+}
+
+static_assert(std::is_base_of_v<sbo::small_vector_impl<int>, sbo::small_vector<int, 4>>);
+static_assert(std::is_base_of_v<sbo::small_vector_impl<int>, sbo::small_vector<int, 16>>);
+static_assert(std::is_base_of_v<sbo::small_vector_impl<int, std::allocator<int>, uint32_t>, sbo::compact_small_vector<int, 8>>);
+
+TEST_CASE("small_vector_impl_accepts_any_N") {
+    sbo::small_vector<std::string, 2> small;
+    sbo::small_vector<std::string, 16> large;
+    append_and_erase_front(small, 10);
+    append_and_erase_front(large, 10);
+    CHECK(small.size() == 10);
+    CHECK(small.front() == "first");
+    CHECK(small.back() == "9");
+    CHECK(small == large);
+    CHECK_FALSE(uses_small_buffer(small));
+    CHECK(uses_small_buffer(large));
+    CHECK(small.inline_capacity() == 2);
+    CHECK(large.inline_capacity() == 16);
+
+    //the small buffer size is remembered while the heap memory is used
+    small.resize(2);
+    small.shrink_to_fit();
+    CHECK(uses_small_buffer(small));
+    CHECK(small.capacity() == 2);
+
+    sbo::small_vector_impl<std::string>& ref = large;
+    ref = small;
+    CHECK(large.size() == 2);
+    CHECK(large.capacity() == 16);
+    //the heap memory is only taken over if the elements don't fit into the small buffer
+    sbo::small_vector<std::string, 2> heap(20, "x");
+    ref = std::move(heap);
+    CHECK(large.size() == 20);
+    CHECK_FALSE(uses_small_buffer(large));
+    CHECK(uses_small_buffer(heap));
+    CHECK(heap.capacity() == 2);
+    large.clear();
+    large.shrink_to_fit();
+    CHECK(large.capacity() == 16);
+}
+
+TEST_CASE("move_between_different_N_takes_over_heap_memory") {
+    allocation_counter counter;
+    using vector8_t = sbo::small_vector<std::string, 8, counting_allocator<std::string>>;
+    using vector16_t = sbo::small_vector<std::string, 16, counting_allocator<std::string>>;
+    vector8_t stage1(20, "x", counting_allocator<std::string>(counter));
+    const std::string* heapData = stage1.data();
+    vector16_t stage2(std::move(stage1));
+    CHECK(counter.allocations == 1);
+    CHECK(stage2.data() == heapData);
+    CHECK(stage2.size() == 20);
+    CHECK(stage1.empty());
+    CHECK(stage1.capacity() == 8);
+    CHECK(uses_small_buffer(stage1));
+
+    stage1 = std::move(stage2);
+    CHECK(counter.allocations == 1);
+    CHECK(stage1.data() == heapData);
+    CHECK(stage2.capacity() == 16);
+
+    //small buffers are moved element wise, into the heap if they don't fit
+    vector16_t small({"a", "b", "c"}, counting_allocator<std::string>(counter));
+    vector8_t fromSmall(std::move(small));
+    CHECK(uses_small_buffer(fromSmall));
+    CHECK(fromSmall == vector8_t({"a", "b", "c"}, counting_allocator<std::string>(counter)));
+    vector16_t large(12, "y", counting_allocator<std::string>(counter));
+    REQUIRE(uses_small_buffer(large));
+    vector8_t fromLarge(std::move(large));
+    CHECK_FALSE(uses_small_buffer(fromLarge));
+    CHECK(fromLarge.size() == 12);
+    CHECK(fromLarge.back() == "y");
+}
+
+TEST_CASE("move_into_larger_N_uses_the_small_buffer") {
+    sbo::small_vector<int, 4> spilled{1, 2, 3, 4, 5, 6};
+    REQUIRE_FALSE(uses_small_buffer(spilled));
+    const size_t spilledCapacity = spilled.capacity();
+    sbo::small_vector<int, 16> constructed(std::move(spilled));
+    CHECK(uses_small_buffer(constructed));
+    CHECK(constructed.capacity() == 16);
+    CHECK(constructed == sbo::small_vector<int, 16>{1, 2, 3, 4, 5, 6});
+    //the source keeps its heap memory
+    CHECK(spilled.empty());
+    CHECK(spilled.capacity() == spilledCapacity);
+
+    spilled.assign({7, 8, 9, 10, 11});
+    sbo::small_vector<std::string, 4> strings{"a", "b", "c", "d", "e"};
+    sbo::small_vector<int, 16> assigned;
+    assigned = std::move(spilled);
+    CHECK(uses_small_buffer(assigned));
+    CHECK(assigned == sbo::small_vector<int, 16>{7, 8, 9, 10, 11});
+    CHECK(spilled.empty());
+    sbo::small_vector<std::string, 8> assignedStrings;
+    assignedStrings = std::move(strings);
+    CHECK(uses_small_buffer(assignedStrings));
+    CHECK(assignedStrings.back() == "e");
+    CHECK(strings.empty());
+}
+
+TEST_CASE("adopt_and_release_to_vector") {
+    sbo::small_vector<std::string, 4> vec{"a"};
+    std::vector<std::string> source{"b", "c", "d", "e", "f"};
+    vec.adopt(std::move(source));
+    CHECK(source.empty());
+    CHECK(vec == sbo::small_vector<std::string, 4>{"b", "c", "d", "e", "f"});
+
+    const std::vector<std::string> released = vec.release_to_vector();
+    CHECK(released == std::vector<std::string>{"b", "c", "d", "e", "f"});
+    CHECK(vec.empty());
+    CHECK(uses_small_buffer(vec));
+    CHECK(vec.capacity() == 4);
+
+    sbo::small_vector<int, 4> ints;
+    ints.adopt(std::vector<int>{1, 2, 3});
+    CHECK(ints == sbo::small_vector<int, 4>{1, 2, 3});
+    CHECK(ints.release_to_vector() == std::vector<int>{1, 2, 3});
+}
+
+//declared trivially relocatable, its copies throw on request
+struct relocatable_throwing {
+    int value = 0;
+    bool throwOnCopy = false;
+    relocatable_throwing(int v, bool t = false) : value(v), throwOnCopy(t) {}
+    relocatable_throwing(const relocatable_throwing& other) : value(other.value) {
+        if (other.throwOnCopy)
+            throw std::runtime_error("copy");
+    }
+    relocatable_throwing& operator=(const relocatable_throwing&) = default;
+    ~relocatable_throwing() {}
+};
+template<>
+struct sbo::is_trivially_relocatable<relocatable_throwing> : std::true_type {};
+
+TEST_CASE("insert_and_erase_shift_trivially_relocatable_elements") {
+    sbo::small_vector<std::unique_ptr<int>, 8> ptrs;
+    for (int i = 0; i < 6; ++i)
+        ptrs.push_back(std::make_unique<int>(i));
+    ptrs.insert(ptrs.begin() + 2, std::make_unique<int>(10));
+    ptrs.emplace(ptrs.begin() + 1, std::make_unique<int>(11));
+    ptrs.erase(ptrs.begin() + 4, ptrs.begin() + 6);
+    ptrs.erase(ptrs.begin());
+    std::vector<int> values;
+    for (const auto& p : ptrs)
+        values.push_back(*p);
+    CHECK(values == std::vector<int>{11, 1, 10, 4, 5});
+
+    //the inserted value references an element which is shifted
+    sbo::small_vector<std::shared_ptr<int>, 8> shared{std::make_shared<int>(1), std::make_shared<int>(2), std::make_shared<int>(3)};
+    shared.insert(shared.begin(), 2, shared[1]);
+    REQUIRE(shared.size() == 5);
+    CHECK(*shared[0] == 2);
+    CHECK(*shared[1] == 2);
+    CHECK(*shared[3] == 2);
+    CHECK(shared[0].use_count() == 3);
+    const std::array<std::shared_ptr<int>, 2> range{std::make_shared<int>(4), std::make_shared<int>(5)};
+    shared.insert(shared.begin() + 1, range.begin(), range.end());
+    CHECK(*shared[1] == 4);
+    CHECK(*shared[2] == 5);
+    CHECK(*shared[3] == 2);
+    CHECK(*shared.back() == 3);
+
+    //the elements are moved back when constructing the new element throws
+    sbo::small_vector<relocatable_throwing, 8> vec{1, 2, 3};
+    const relocatable_throwing throwing(4, true);
+    CHECK_THROWS_AS(vec.insert(vec.begin() + 1, throwing), std::runtime_error);
+    CHECK_THROWS_AS(vec.insert(vec.begin(), 2, throwing), std::runtime_error);
+    REQUIRE(vec.size() == 3);
+    CHECK(vec[0].value == 1);
+    CHECK(vec[1].value == 2);
+    CHECK(vec[2].value == 3);
+}
@@ -0,0 +1,72 @@
+// Licensed under the Unlicense <https://unlicense.org/>
+// SPDX-License-Identifier: Unlicense
+//a separate executable, SBO_SPILL_TELEMETRY is defined for all of its translation units (see test/CMakeLists.txt)
+#if !defined(SBO_SPILL_TELEMETRY)
+#  error "spill_telemetry_tests needs SBO_SPILL_TELEMETRY"
+#endif
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <small_vector/small_vector.h>
+
+#include <string>
+
+namespace {
+    struct spill_probe {
+        int value;
+    };
+    struct inline_probe {
+        int value;
+    };
+}
+
+TEST_CASE("spill_telemetry_counts_spills_and_reallocations") {
+    sbo::reset_spill_telemetry();
+    {
+        sbo::small_vector<spill_probe, 4> vec;
+        for (int i = 0; i < 9; ++i)
+            vec.push_back({i});
+        sbo::small_vector<spill_probe, 4> reserved;
+        reserved.reserve(20);
+        //the small buffer is enough, so nothing is recorded
+        sbo::small_vector<inline_probe, 4> small(4);
+        small.reserve(3);
+    }
+    auto stats = sbo::spill_telemetry_for<spill_probe, 4>();
+    CHECK(stats.type.find("spill_probe") != std::string_view::npos);
+    CHECK(stats.n == 4);
+    //the 5th element spills, the 9th one grows the heap memory of capacity 8
+    CHECK(stats.spills == 2);
+    CHECK(stats.reallocations == 1);
+    CHECK(stats.maxRequested == 20);
+    CHECK(stats.histogram[3] == 1);
+    CHECK(stats.histogram[4] == 1);
+    CHECK(stats.histogram[5] == 1);
+    CHECK(sbo::spill_telemetry_for<inline_probe, 4>().spills == 0);
+
+    //the shared growth path of small_vector_impl keeps the counters of each N apart
+    sbo::small_vector<spill_probe, 8> larger(10);
+    CHECK(sbo::spill_telemetry_for<spill_probe, 8>().spills == 1);
+    CHECK(sbo::spill_telemetry_for<spill_probe, 4>().spills == 2);
+
+    sbo::reset_spill_telemetry();
+    stats = sbo::spill_telemetry_for<spill_probe, 4>();
+    CHECK(stats.spills == 0);
+    CHECK(stats.reallocations == 0);
+    CHECK(stats.maxRequested == 0);
+}
+
+TEST_CASE("spill_telemetry_json") {
+    sbo::reset_spill_telemetry();
+    {
+        sbo::small_vector<spill_probe, 4> vec;
+        vec.reserve(6);
+        vec.reserve(12);
+    }
+    const std::string json = sbo::spill_telemetry_json();
+    CHECK(json.front() == '[');
+    CHECK(json.back() == ']');
+    const size_t entry = json.find("spill_probe");
+    REQUIRE(entry != std::string::npos);
+    CHECK(json.find("\"n\": 4, \"spills\": 1, \"reallocations\": 1, \"max_requested\": 12, \"log2_histogram\": [0, 0, 0, 1, 1]}",
+                    entry) != std::string::npos);
+}